@@ -20,6 +20,7 @@ import glob
 import math
 import os
 import re
+import struct
 
 from bokeh.plotting import figure
 import numpy as np
@@ -137,18 +138,44 @@ def parse_yaml(config):
     return config_data
 
 
+BINARY_LOG_MAGIC = b'EKFCALBL'
+BINARY_LOG_VERSION = 1
+
+
+def read_binary_log(file_path):
+    """Memory-map a binary columnar log into a data frame without parsing."""
+    with open(file_path, 'rb') as stream:
+        magic = stream.read(len(BINARY_LOG_MAGIC))
+        version, column_count, names_size = struct.unpack('<IIQ', stream.read(16))
+        if magic != BINARY_LOG_MAGIC or version != BINARY_LOG_VERSION:
+            raise ValueError(f'Invalid binary log file: {file_path}')
+        names = stream.read(names_size).rstrip(b'\0').decode().split(',')
+    offset = len(BINARY_LOG_MAGIC) + 16 + names_size
+    row_size = 8 * column_count
+    row_count = (os.path.getsize(file_path) - offset) // row_size if row_size else 0
+    if row_count == 0:
+        return pd.DataFrame(columns=names, dtype=np.float64)
+    data = np.memmap(file_path, dtype='<f8', mode='r', offset=offset,
+                     shape=(row_count, column_count))
+    return pd.DataFrame(data, columns=names, copy=False)
+
+
 def find_and_read_data_frames(directories, prefix):
-    """Find matching dataframes and read using pandas."""
+    """Find matching dataframes and read using pandas or a binary log memory map."""
     data_frame_sets = collections.defaultdict(list)
     for directory in directories:
         file_paths_id = glob.glob(os.path.join(directory, prefix + '*.csv'))
+        file_paths_id += glob.glob(os.path.join(directory, prefix + '*.bin'))
         for file_path in file_paths_id:
             file_name = os.path.basename(file_path)
-            df = pd.read_csv(file_path)
+            if file_path.endswith('.bin'):
+                df = read_binary_log(file_path)
+            else:
+                df = pd.read_csv(file_path)
             df.attrs['prefix'] = format_prefix(prefix)
-            matches = re.findall(r'_[0-9]*\.csv', file_name)
+            matches = re.findall(r'_([0-9]+)\.(?:csv|bin)$', file_name)
             if matches:
-                file_id = int(matches[0].split('_')[1].split('.csv')[0])
+                file_id = int(matches[0])
             else:
                 file_id = 0
             df.attrs['id'] = file_id
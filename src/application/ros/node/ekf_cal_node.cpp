@@ -17,8 +17,10 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -53,9 +55,17 @@ EkfCalNode::EkfCalNode()
   // Declare Parameters
   this->declare_parameter("debug_log_level", 0);
   this->declare_parameter("data_logging_on", false);
+  this->declare_parameter("data_log_binary", false);
+  this->declare_parameter("data_log_drop_when_full", false);
+  this->declare_parameter("data_log_queue_size", 4096);
+  this->declare_parameter("data_log_flush_period", 1.0);
   this->declare_parameter("imu_list", std::vector<std::string>{});
   this->declare_parameter("camera_list", std::vector<std::string>{});
   this->declare_parameter("tracker_list", std::vector<std::string>{});
+  this->declare_parameter("tracking_threads", 0);
+  this->declare_parameter("feature_association", false);
+  this->declare_parameter("association_window", 0.1);
+  this->declare_parameter("epipolar_threshold", 0.01);
 
   m_state_pub_timer =
     this->create_wall_timer(std::chrono::seconds(1), std::bind(&EkfCalNode::PublishState, this));
@@ -66,6 +76,16 @@ void EkfCalNode::Initialize()
   // Set logging
   auto debug_log_level = static_cast<unsigned int>(this->get_parameter("debug_log_level").as_int());
   bool data_logging_on = this->get_parameter("data_logging_on").as_bool();
+  if (this->get_parameter("data_log_binary").as_bool()) {
+    DataLogger::SetDefaultLogFormat(DataLogger::LogFormat::BINARY);
+  }
+  if (this->get_parameter("data_log_drop_when_full").as_bool()) {
+    DataLogger::SetDefaultOverflowPolicy(DataLogger::OverflowPolicy::DROP);
+  }
+  DataLogger::SetDefaultQueueSize(
+    static_cast<unsigned int>(
+      std::max(this->get_parameter("data_log_queue_size").as_int(), static_cast<int64_t>(2))));
+  DataLogger::SetDefaultFlushPeriod(this->get_parameter("data_log_flush_period").as_double());
   m_logger = std::make_shared<DebugLogger>(debug_log_level, "");
   m_state_data_logger.SetLogging(data_logging_on);
   m_state_data_logger.SetOutputDirectory("~/log/");
@@ -78,6 +98,17 @@ void EkfCalNode::Initialize()
   m_imu_list = this->get_parameter("imu_list").as_string_array();
   m_camera_list = this->get_parameter("camera_list").as_string_array();
   m_tracker_list = this->get_parameter("tracker_list").as_string_array();
+  m_tracking_threads = static_cast<unsigned int>(
+    std::max(this->get_parameter("tracking_threads").as_int(), static_cast<int64_t>(0)));
+
+  // Overlapping cameras share completed feature tracks before the MSCKF update
+  if (this->get_parameter("feature_association").as_bool()) {
+    m_feature_associator = std::make_shared<FeatureAssociator>(
+      m_ekf,
+      this->get_parameter("association_window").as_double(),
+      this->get_parameter("epipolar_threshold").as_double(),
+      m_logger);
+  }
 }
 
 void EkfCalNode::DeclareSensors()
@@ -189,6 +220,7 @@ void EkfCalNode::DeclareCameraParameters(std::string camera_name)
   this->declare_parameter(cam_prefix + ".ang_c_to_b", std::vector<double>{1, 0, 0, 0});
   this->declare_parameter(cam_prefix + ".variance", std::vector<double>{1, 1, 1, 1, 1, 1});
   this->declare_parameter(cam_prefix + ".tracker", "");
+  this->declare_parameter(cam_prefix + ".async_tracking", false);
 }
 
 Camera::Parameters EkfCalNode::GetCameraParameters(std::string camera_name)
@@ -203,6 +235,7 @@ Camera::Parameters EkfCalNode::GetCameraParameters(std::string camera_name)
     this->get_parameter(cam_prefix + ".ang_c_to_b").as_double_array();
   std::vector<double> variance = this->get_parameter(cam_prefix + ".variance").as_double_array();
   std::string tracker_name = this->get_parameter(cam_prefix + ".tracker").as_string();
+  bool async_tracking = this->get_parameter(cam_prefix + ".async_tracking").as_bool();
 
   // Assign parameters to struct
   Camera::Parameters camera_params;
@@ -213,6 +246,7 @@ Camera::Parameters EkfCalNode::GetCameraParameters(std::string camera_name)
   camera_params.ang_c_to_b = StdToEigQuat(ang_c_to_b);
   camera_params.variance = StdToEigVec(variance);
   camera_params.tracker = tracker_name;
+  camera_params.async_tracking = async_tracking;
   camera_params.ekf = m_ekf;
   camera_params.logger = m_logger;
   return camera_params;
@@ -227,6 +261,22 @@ void EkfCalNode::DeclareTrackerParameters(std::string tracker_name)
   this->declare_parameter(tracker_prefix + ".descriptor_extractor", 0);
   this->declare_parameter(tracker_prefix + ".descriptor_matcher", 0);
   this->declare_parameter(tracker_prefix + ".detector_threshold", 20.0);
+  this->declare_parameter(tracker_prefix + ".tracking_mode", 0);
+  this->declare_parameter(tracker_prefix + ".klt_window_size", 21);
+  this->declare_parameter(tracker_prefix + ".klt_pyramid_levels", 3);
+  this->declare_parameter(tracker_prefix + ".klt_max_error", 1.0);
+  this->declare_parameter(tracker_prefix + ".gyro_prediction", true);
+  this->declare_parameter(tracker_prefix + ".mutual_check", true);
+  this->declare_parameter(tracker_prefix + ".ratio_test", 0.8);
+  this->declare_parameter(tracker_prefix + ".nms_cell_size", 10);
+  this->declare_parameter(tracker_prefix + ".nms_cell_quota", 1);
+  this->declare_parameter(tracker_prefix + ".image_width", 640);
+  this->declare_parameter(tracker_prefix + ".image_height", 480);
+  this->declare_parameter(tracker_prefix + ".roi", std::vector<int64_t>{0, 0, 0, 0});
+  this->declare_parameter(tracker_prefix + ".max_features", 1000);
+  this->declare_parameter(tracker_prefix + ".min_features", 50);
+  this->declare_parameter(tracker_prefix + ".target_frame_time", 0.0);
+  this->declare_parameter(tracker_prefix + ".target_track_count", 0);
 }
 
 FeatureTracker::Parameters EkfCalNode::GetTrackerParameters(std::string tracker_name)
@@ -236,11 +286,42 @@ FeatureTracker::Parameters EkfCalNode::GetTrackerParameters(std::string tracker_
   int detector = this->get_parameter(tracker_prefix + ".feature_detector").as_int();
   int extractor = this->get_parameter(tracker_prefix + ".descriptor_extractor").as_int();
   int matcher = this->get_parameter(tracker_prefix + ".descriptor_matcher").as_int();
+  int tracking_mode = this->get_parameter(tracker_prefix + ".tracking_mode").as_int();
+  int klt_window_size = this->get_parameter(tracker_prefix + ".klt_window_size").as_int();
+  int klt_pyramid_levels = this->get_parameter(tracker_prefix + ".klt_pyramid_levels").as_int();
+  int nms_cell_size = this->get_parameter(tracker_prefix + ".nms_cell_size").as_int();
+  int nms_cell_quota = this->get_parameter(tracker_prefix + ".nms_cell_quota").as_int();
+  int image_width = this->get_parameter(tracker_prefix + ".image_width").as_int();
+  int image_height = this->get_parameter(tracker_prefix + ".image_height").as_int();
+  std::vector<int64_t> roi = this->get_parameter(tracker_prefix + ".roi").as_integer_array();
+  int max_features = this->get_parameter(tracker_prefix + ".max_features").as_int();
+  int min_features = this->get_parameter(tracker_prefix + ".min_features").as_int();
+  int target_track_count = this->get_parameter(tracker_prefix + ".target_track_count").as_int();
 
   FeatureTracker::Parameters tracker_params;
   tracker_params.detector = static_cast<FeatureTracker::FeatureDetectorEnum>(detector);
   tracker_params.descriptor = static_cast<FeatureTracker::DescriptorExtractorEnum>(extractor);
   tracker_params.matcher = static_cast<FeatureTracker::DescriptorMatcherEnum>(matcher);
+  tracker_params.tracking_mode = static_cast<FeatureTracker::TrackingModeEnum>(tracking_mode);
+  tracker_params.klt_window_size = static_cast<unsigned int>(std::max(klt_window_size, 3));
+  tracker_params.klt_pyramid_levels = static_cast<unsigned int>(std::max(klt_pyramid_levels, 0));
+  tracker_params.klt_max_error = this->get_parameter(tracker_prefix + ".klt_max_error").as_double();
+  tracker_params.gyro_prediction =
+    this->get_parameter(tracker_prefix + ".gyro_prediction").as_bool();
+  tracker_params.mutual_check = this->get_parameter(tracker_prefix + ".mutual_check").as_bool();
+  tracker_params.ratio_test = this->get_parameter(tracker_prefix + ".ratio_test").as_double();
+  tracker_params.nms_cell_size = static_cast<unsigned int>(std::max(nms_cell_size, 0));
+  tracker_params.nms_cell_quota = static_cast<unsigned int>(std::max(nms_cell_quota, 1));
+  tracker_params.image_width = static_cast<unsigned int>(std::max(image_width, 0));
+  tracker_params.image_height = static_cast<unsigned int>(std::max(image_height, 0));
+  if (roi.size() == 4) {
+    tracker_params.roi = cv::Rect(roi[0], roi[1], roi[2], roi[3]);
+  }
+  tracker_params.max_features = static_cast<unsigned int>(std::max(max_features, 1));
+  tracker_params.min_features = static_cast<unsigned int>(std::max(min_features, 0));
+  tracker_params.target_frame_time =
+    this->get_parameter(tracker_prefix + ".target_frame_time").as_double();
+  tracker_params.target_track_count = static_cast<unsigned int>(std::max(target_track_count, 0));
   tracker_params.threshold =
     this->get_parameter(tracker_prefix + ".detector_threshold").as_double();
   tracker_params.ekf = m_ekf;
@@ -291,6 +372,22 @@ void EkfCalNode::LoadCamera(std::string camera_name)
   std::shared_ptr<FeatureTracker> trkPtr = std::make_shared<FeatureTracker>(tParams);
   camera_ptr->AddTracker(trkPtr);
 
+  if (m_feature_associator) {
+    m_feature_associator->AddCamera(camera_ptr->GetId(), tParams.intrinsics);
+    trkPtr->SetFeatureAssociator(m_feature_associator);
+  }
+
+  // Asynchronous cameras share one worker pool and one ordered update queue
+  if (camera_params.async_tracking) {
+    if (!m_tracking_pool) {
+      m_tracking_pool = std::make_shared<TrackingPool>(m_tracking_threads);
+      m_logger->Log(
+        LogLevel::INFO, "Tracking pool threads: " +
+        std::to_string(m_tracking_pool->GetThreadCount()));
+    }
+    camera_ptr->SetTrackingPool(m_tracking_pool);
+  }
+
   RegisterCamera(camera_ptr, camera_params.topic);
 }
 
@@ -326,8 +423,14 @@ void EkfCalNode::CameraCallback(const sensor_msgs::msg::Image::SharedPtr msg, un
   if (rosCamIter != m_map_camera.end()) {
     auto ros_camera_message = std::make_shared<RosCameraMessage>(msg);
     ros_camera_message->m_sensor_id = id;
+
+    // Skip track image rendering when nobody is listening
+    bool draw_output = m_img_publisher->get_subscription_count() > 0;
+    rosCamIter->second->SetDrawOutput(draw_output);
     rosCamIter->second->Callback(ros_camera_message);
-    m_img_publisher->publish(*rosCamIter->second->GetRosImage().get());
+    if (draw_output && rosCamIter->second->GetRosImage()) {
+      m_img_publisher->publish(*rosCamIter->second->GetRosImage().get());
+    }
   } else {
     m_logger->Log(LogLevel::WARN, "Camera ID Not Found: " + std::to_string(id));
   }
@@ -32,7 +32,9 @@
 #include "infrastructure/debug_logger.hpp"
 #include "sensors/camera.hpp"
 #include "sensors/imu.hpp"
+#include "trackers/feature_associator.hpp"
 #include "trackers/feature_tracker.hpp"
+#include "trackers/tracking_pool.hpp"
 
 class RosCamera;
 class RosIMU;
@@ -170,6 +172,9 @@ private:
 
   std::shared_ptr<EKF> m_ekf;
   std::shared_ptr<DebugLogger> m_logger;
+  std::shared_ptr<TrackingPool> m_tracking_pool;
+  std::shared_ptr<FeatureAssociator> m_feature_associator;
+  unsigned int m_tracking_threads {0U};
   DataLogger m_state_data_logger;
 
 
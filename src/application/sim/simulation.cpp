@@ -43,6 +43,7 @@
 #include "sensors/sim/sim_imu_message.hpp"
 #include "sensors/sim/sim_imu.hpp"
 #include "sensors/types.hpp"
+#include "trackers/feature_associator.hpp"
 #include "trackers/feature_tracker.hpp"
 #include "trackers/sim/sim_feature_tracker.hpp"
 #include "trackers/sim/sim_fiducial_tracker.hpp"
@@ -93,6 +94,14 @@ int main(int argc, char * argv[])
   YAML::Node ros_params = root["/EkfCalNode"]["ros__parameters"];
   unsigned int debug_log_level = ros_params["debug_log_level"].as<unsigned int>(0U);
   bool data_logging_on = ros_params["data_logging_on"].as<bool>(true);
+  if (ros_params["data_log_binary"].as<bool>(false)) {
+    DataLogger::SetDefaultLogFormat(DataLogger::LogFormat::BINARY);
+  }
+  if (ros_params["data_log_drop_when_full"].as<bool>(false)) {
+    DataLogger::SetDefaultOverflowPolicy(DataLogger::OverflowPolicy::DROP);
+  }
+  DataLogger::SetDefaultQueueSize(ros_params["data_log_queue_size"].as<unsigned int>(4096U));
+  DataLogger::SetDefaultFlushPeriod(ros_params["data_log_flush_period"].as<double>(1.0));
   double body_data_rate = ros_params["body_data_rate"].as<double>(1.0);
   std::vector<double> process_noise =
     ros_params["filter_params"]["process_noise"].as<std::vector<double>>();
@@ -116,6 +125,16 @@ int main(int argc, char * argv[])
   auto ekf = std::make_shared<EKF>(debug_logger, body_data_rate, data_logging_on, out_dir);
   ekf->SetProcessNoise(StdToEigVec(process_noise));
 
+  // Overlapping cameras share completed feature tracks before the MSCKF update
+  std::shared_ptr<FeatureAssociator> feature_associator;
+  if (ros_params["feature_association"].as<bool>(false)) {
+    feature_associator = std::make_shared<FeatureAssociator>(
+      ekf,
+      ros_params["association_window"].as<double>(0.1),
+      ros_params["epipolar_threshold"].as<double>(0.01),
+      debug_logger);
+  }
+
   std::vector<double> def_vec{0.0, 0.0, 0.0};
   std::vector<double> def_quat{1.0, 0.0, 0.0, 0.0};
   std::vector<std::vector<double>> def_mat{{0.0, 0.0, 0.0}};
@@ -257,6 +276,12 @@ int main(int argc, char * argv[])
     track_params.max_track_length = trk_node["max_track_length"].as<unsigned int>(20U);
     track_params.data_log_rate = trk_node["data_log_rate"].as<double>(0.0);
     track_params.min_feat_dist = trk_node["min_feat_dist"].as<double>(1.0);
+    track_params.batch_triangulation = trk_node["batch_triangulation"].as<bool>(true);
+    track_params.triangulation_method = static_cast<MsckfUpdater::TriangulationMethod>(
+      trk_node["triangulation_method"].as<unsigned int>(0U));
+    track_params.max_update_rows = trk_node["max_update_rows"].as<unsigned int>(0U);
+    track_params.max_update_time = trk_node["max_update_time"].as<double>(0.0);
+    track_params.chi_squared_gating = trk_node["chi_squared_gating"].as<bool>(true);
     track_params.logger = debug_logger;
     track_params.ekf = ekf;
     max_track_length = std::max(max_track_length, track_params.max_track_length);
@@ -275,6 +300,7 @@ int main(int argc, char * argv[])
   // Load board detectors
   debug_logger->Log(LogLevel::INFO, "Loading Board Detectors");
   std::map<std::string, SimFiducialTracker::Parameters> fiducial_map;
+  unsigned int board_count {0U};
   for (unsigned int i = 0; i < fiducials.size(); ++i) {
     YAML::Node fid_node = root["/EkfCalNode"]["ros__parameters"]["fiducial"][fiducials[i]];
     YAML::Node sim_node = fid_node["sim_params"];
@@ -295,6 +321,40 @@ int main(int argc, char * argv[])
     fiducial_params.min_track_length = fid_node["min_track_length"].as<unsigned int>(2U);
     fiducial_params.max_track_length = fid_node["max_track_length"].as<unsigned int>(20U);
     fiducial_params.data_log_rate = fid_node["data_log_rate"].as<double>(0.0);
+    fiducial_params.chi_squared_gating = fid_node["chi_squared_gating"].as<bool>(true);
+    fiducial_params.detector_type = static_cast<FiducialTracker::FiducialTypeEnum>(
+      fid_node["fiducial_type"].as<int>(1));
+    fiducial_params.predefined_dictionary = static_cast<cv::aruco::PREDEFINED_DICTIONARY_NAME>(
+      fid_node["predefined_dictionary"].as<int>(cv::aruco::DICT_6X6_250));
+    fiducial_params.corner_refinement = static_cast<cv::aruco::CornerRefineMethod>(
+      fid_node["corner_refinement"].as<int>(cv::aruco::CORNER_REFINE_NONE));
+    fiducial_params.adaptive_thresh_win_size_min =
+      fid_node["adaptive_thresh_win_size_min"].as<int>(3);
+    fiducial_params.adaptive_thresh_win_size_max =
+      fid_node["adaptive_thresh_win_size_max"].as<int>(23);
+    fiducial_params.adaptive_thresh_win_size_step =
+      fid_node["adaptive_thresh_win_size_step"].as<int>(10);
+    fiducial_params.min_marker_perimeter_rate =
+      fid_node["min_marker_perimeter_rate"].as<double>(0.03);
+    fiducial_params.predict_roi = fid_node["predict_roi"].as<bool>(false);
+    fiducial_params.roi_padding = fid_node["roi_padding"].as<double>(0.25);
+    fiducial_params.full_search_interval = fid_node["full_search_interval"].as<unsigned int>(10U);
+    fiducial_params.initial_id = fid_node["initial_id"].as<unsigned int>(0U);
+
+    // Additional boards default to the marker IDs following the previous board
+    unsigned int marker_count = fiducial_params.squares_x * fiducial_params.squares_y / 2;
+    unsigned int initial_id = fiducial_params.initial_id;
+    for (auto const & board_node : fid_node["boards"]) {
+      FiducialTracker::BoardParameters board_params;
+      board_params.pos_f_in_g =
+        StdToEigVec(board_node["pos_f_in_g"].as<std::vector<double>>(def_vec));
+      board_params.ang_f_to_g =
+        StdToEigQuat(board_node["ang_f_to_g"].as<std::vector<double>>(def_quat));
+      board_params.initial_id =
+        board_node["initial_id"].as<unsigned int>(initial_id + marker_count);
+      initial_id = board_params.initial_id;
+      fiducial_params.boards.push_back(board_params);
+    }
     fiducial_params.logger = debug_logger;
     fiducial_params.ekf = ekf;
     max_track_length = std::max(max_track_length, fiducial_params.max_track_length);
@@ -309,21 +369,28 @@ int main(int argc, char * argv[])
     sim_fiducial_params.r_vec_error =
       StdToEigVec(sim_node["r_vec_error"].as<std::vector<double>>(def_vec));
     sim_fiducial_params.no_errors = no_errors;
+    sim_fiducial_params.truth_board_id = board_count;
     sim_fiducial_params.fiducial_params = fiducial_params;
 
     fiducial_map[fiducial_params.name] = sim_fiducial_params;
 
-    Eigen::Vector3d pos_f_in_g_true;
-    Eigen::Quaterniond ang_f_to_g_true;
-    if (no_errors) {
-      pos_f_in_g_true = fiducial_params.pos_f_in_g;
-      ang_f_to_g_true = fiducial_params.ang_f_to_g;
-    } else {
-      pos_f_in_g_true = rng.VecNormRand(fiducial_params.pos_f_in_g, sim_fiducial_params.pos_error);
-      ang_f_to_g_true = rng.QuatNormRand(fiducial_params.ang_f_to_g, sim_fiducial_params.ang_error);
+    std::vector<FiducialTracker::BoardParameters> boards;
+    boards.push_back({fiducial_params.pos_f_in_g, fiducial_params.ang_f_to_g, 0U});
+    boards.insert(boards.end(), fiducial_params.boards.begin(), fiducial_params.boards.end());
+    for (auto const & board_params : boards) {
+      Eigen::Vector3d pos_f_in_g_true;
+      Eigen::Quaterniond ang_f_to_g_true;
+      if (no_errors) {
+        pos_f_in_g_true = board_params.pos_f_in_g;
+        ang_f_to_g_true = board_params.ang_f_to_g;
+      } else {
+        pos_f_in_g_true = rng.VecNormRand(board_params.pos_f_in_g, sim_fiducial_params.pos_error);
+        ang_f_to_g_true = rng.QuatNormRand(board_params.ang_f_to_g, sim_fiducial_params.ang_error);
+      }
+      truth_engine->SetBoardPosition(board_count, pos_f_in_g_true);
+      truth_engine->SetBoardOrientation(board_count, ang_f_to_g_true);
+      ++board_count;
     }
-    truth_engine->SetBoardPosition(i, pos_f_in_g_true);
-    truth_engine->SetBoardOrientation(i, ang_f_to_g_true);
   }
   ekf->SetMaxTrackLength(max_track_length);
 
@@ -375,6 +442,10 @@ int main(int argc, char * argv[])
       trk_params.tracker_params.sensor_id = cam->GetId();
       trk_params.tracker_params.intrinsics = cam_params.intrinsics;
       auto trk = std::make_shared<SimFeatureTracker>(trk_params, truth_engine);
+      if (feature_associator) {
+        feature_associator->AddCamera(cam->GetId(), cam_params.intrinsics);
+        trk->SetFeatureAssociator(feature_associator);
+      }
       cam->AddTracker(trk);
     }
     if (!cam_params.fiducial.empty()) {
@@ -0,0 +1,75 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "infrastructure/binary_log.hpp"
+
+int main(int argc, char * argv[])
+{
+  if ((argc < 2) || (argc > 3)) {
+    std::cout << "Convert a binary columnar data log to CSV" << std::endl;
+    std::cout << "Usage: binary_log_to_csv <input.bin> [output.csv]" << std::endl;
+    return 1;
+  }
+
+  std::string input_path = argv[1];
+  std::string output_path;
+  if (argc == 3) {
+    output_path = argv[2];
+  } else if ((input_path.size() > 4) && (input_path.substr(input_path.size() - 4) == ".bin")) {
+    output_path = input_path.substr(0, input_path.size() - 4) + ".csv";
+  } else {
+    output_path = input_path + ".csv";
+  }
+
+  BinaryLogReader reader(input_path);
+  if (!reader.IsValid()) {
+    std::cerr << "Invalid binary log file: " << input_path << std::endl;
+    return 1;
+  }
+
+  std::ofstream output(output_path);
+  if (!output) {
+    std::cerr << "Could not open output file: " << output_path << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> columns = reader.GetColumns();
+  for (unsigned int i = 0; i < columns.size(); ++i) {
+    output << (i > 0 ? "," : "") << columns[i];
+  }
+  output << "\n";
+
+  // Enough digits to round trip every value
+  output << std::setprecision(std::numeric_limits<double>::max_digits10);
+  std::vector<double> row;
+  unsigned int row_count {0U};
+  while (reader.ReadRow(row)) {
+    for (unsigned int i = 0; i < row.size(); ++i) {
+      output << (i > 0 ? "," : "") << row[i];
+    }
+    output << "\n";
+    ++row_count;
+  }
+
+  std::cout << "Wrote " << row_count << " rows to " << output_path << std::endl;
+  return 0;
+}
@@ -69,19 +69,17 @@ Eigen::MatrixXd EKF::GetStateTransition(double dT)
 
 void EKF::LogBodyStateIfNeeded()
 {
-  if (m_data_logging_on) {
-    std::stringstream msg;
-    Eigen::VectorXd body_cov =
-      GetCov().block<g_body_state_size, g_body_state_size>(0, 0).diagonal();
-    msg << m_current_time;
-    msg << VectorToCommaString(GetState().m_body_state.m_position);
-    msg << VectorToCommaString(GetState().m_body_state.m_velocity);
-    msg << VectorToCommaString(GetState().m_body_state.m_acceleration);
-    msg << QuaternionToCommaString(GetState().m_body_state.m_ang_b_to_g);
-    msg << VectorToCommaString(GetState().m_body_state.m_angular_velocity);
-    msg << VectorToCommaString(GetState().m_body_state.m_angular_acceleration);
-    msg << VectorToCommaString(body_cov);
-    m_data_logger.RateLimitedLog(msg.str(), m_current_time);
+  if (m_data_logging_on && m_data_logger.IsLogDue(m_current_time)) {
+    DataRecord & record = m_data_logger.NewRecord();
+    record.Append(m_current_time);
+    record.Append(GetState().m_body_state.m_position);
+    record.Append(GetState().m_body_state.m_velocity);
+    record.Append(GetState().m_body_state.m_acceleration);
+    record.Append(GetState().m_body_state.m_ang_b_to_g);
+    record.Append(GetState().m_body_state.m_angular_velocity);
+    record.Append(GetState().m_body_state.m_angular_acceleration);
+    record.Append(GetCov().block<g_body_state_size, g_body_state_size>(0, 0).diagonal());
+    m_data_logger.LogRecord();
   }
 }
 
@@ -446,8 +444,8 @@ void EKF::AugmentState(unsigned int camera_id, int frame_id)
   unsigned int aug_state_start;
   unsigned int cam_state_start = GetCamStateStartIndex(camera_id);
 
-  // Limit augmented states to m_max_track_length
-  if (m_state.m_cam_states[camera_id].augmented_states.size() <= m_max_track_length) {
+  // Limit augmented states to the camera's clone count
+  if (m_state.m_cam_states[camera_id].augmented_states.size() <= GetMaxCloneCount(camera_id)) {
     aug_state_start = GetAugStateStartIndex(camera_id, frame_id);
 
     m_stateSize += g_aug_state_size;
@@ -471,6 +469,20 @@ void EKF::AugmentState(unsigned int camera_id, int frame_id)
   m_cov = (augment_jacobian * m_cov * augment_jacobian.transpose()).eval();
 }
 
+void EKF::RemoveAugmentedState(unsigned int camera_id, int frame_id)
+{
+  auto & augmented_states = m_state.m_cam_states[camera_id].augmented_states;
+  for (auto aug_iter = augmented_states.begin(); aug_iter != augmented_states.end(); ++aug_iter) {
+    if (aug_iter->frame_id == frame_id) {
+      unsigned int aug_state_start = GetAugStateStartIndex(camera_id, frame_id);
+      augmented_states.erase(aug_iter);
+      m_cov = RemoveFromMatrix(m_cov, aug_state_start, aug_state_start, g_aug_state_size);
+      m_stateSize -= g_aug_state_size;
+      return;
+    }
+  }
+}
+
 void EKF::SetProcessNoise(Eigen::VectorXd process_noise)
 {
   m_process_noise = process_noise.asDiagonal();
@@ -496,3 +508,36 @@ void EKF::SetMaxTrackLength(unsigned int max_track_length)
 {
   m_max_track_length = max_track_length;
 }
+
+unsigned int EKF::GetMaxTrackLength()
+{
+  return m_max_track_length;
+}
+
+void EKF::SetCloneHeadroom(unsigned int camera_id, unsigned int clone_headroom)
+{
+  m_clone_headroom[camera_id] = clone_headroom;
+}
+
+unsigned int EKF::GetMaxCloneCount(unsigned int camera_id)
+{
+  auto headroom_iter = m_clone_headroom.find(camera_id);
+  if (headroom_iter == m_clone_headroom.end()) {
+    return m_max_track_length;
+  }
+  return m_max_track_length + headroom_iter->second;
+}
+
+bool EKF::HasAugmentedState(int camera_id, int frame_id)
+{
+  auto cam_iter = m_state.m_cam_states.find(camera_id);
+  if (cam_iter == m_state.m_cam_states.end()) {
+    return false;
+  }
+  for (auto const & aug_state : cam_iter->second.augmented_states) {
+    if (aug_state.frame_id == frame_id) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -19,6 +19,7 @@
 #include <eigen3/Eigen/Eigen>
 #include <stddef.h>
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -189,12 +190,39 @@ public:
   ///
   void AugmentState(unsigned int camera_id, int frame_id);
 
+  ///
+  /// @brief Function to remove an augmented state that will never be observed
+  /// @param camera_id Camera ID
+  /// @param frame_id Frame ID of the augmented state
+  ///
+  void RemoveAugmentedState(unsigned int camera_id, int frame_id);
+
   ///
   /// @brief Setter for maximum track length
   /// @param max_track_length maximum track length
   ///
   void SetMaxTrackLength(unsigned int max_track_length);
 
+  ///
+  /// @brief Getter for maximum track length
+  /// @return Maximum number of augmented states kept per camera
+  ///
+  unsigned int GetMaxTrackLength();
+
+  ///
+  /// @brief Setter for augmented states kept beyond the maximum track length
+  /// @param camera_id Camera ID
+  /// @param clone_headroom Number of additional augmented states kept for the camera
+  ///
+  void SetCloneHeadroom(unsigned int camera_id, unsigned int clone_headroom);
+
+  ///
+  /// @brief Getter for the number of augmented states kept for a camera
+  /// @param camera_id Camera ID
+  /// @return Maximum track length plus the camera's clone headroom
+  ///
+  unsigned int GetMaxCloneCount(unsigned int camera_id);
+
   ///
   /// @brief Function to add process noise to covariance
   ///
@@ -214,6 +242,14 @@ public:
   ///
   AugmentedState MatchState(int camera_id, int frame_id);
 
+  ///
+  /// @brief Check if an augmented state is still held in the state
+  /// @param camera_id Desired camera ID
+  /// @param frame_id Desired frame ID
+  /// @return True if the camera holds an augmented state for the frame
+  ///
+  bool HasAugmentedState(int camera_id, int frame_id);
+
 private:
   unsigned int m_stateSize{g_body_state_size};
   State m_state;
@@ -223,6 +259,7 @@ private:
   std::shared_ptr<DebugLogger> m_logger;
   bool m_data_logging_on;
   unsigned int m_max_track_length{20};
+  std::map<unsigned int, unsigned int> m_clone_headroom;
   Eigen::MatrixXd m_process_noise =
     Eigen::MatrixXd::Identity(g_body_state_size, g_body_state_size) * 1e-9;
   DataLogger m_data_logger;
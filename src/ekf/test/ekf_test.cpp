@@ -18,6 +18,7 @@
 
 #include <vector>
 
+#include "ekf/constants.hpp"
 #include "ekf/ekf.hpp"
 #include "ekf/types.hpp"
 
@@ -55,6 +56,53 @@ TEST(test_EKF, get_counts) {
   EXPECT_EQ(ekf->GetAugStateStartIndex(1, 1), 42U);
 }
 
+TEST(test_EKF, remove_augmented_state) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(debug_logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Identity(6, 6));
+  for (int frame_id = 0; frame_id < 3; ++frame_id) {
+    ekf->AugmentState(1, frame_id);
+  }
+  unsigned int state_size = ekf->GetState().GetStateSize();
+  unsigned int aug_state_start = ekf->GetAugStateStartIndex(1, 2);
+  ekf->GetCov()(aug_state_start, aug_state_start) = 5.0;
+
+  ekf->RemoveAugmentedState(1, 1);
+  EXPECT_EQ(ekf->GetCamState(1).augmented_states.size(), 2U);
+  EXPECT_EQ(ekf->GetState().GetStateSize(), state_size - g_aug_state_size);
+  EXPECT_EQ(static_cast<unsigned int>(ekf->GetCov().rows()), state_size - g_aug_state_size);
+
+  // Later clones shift down with their covariance
+  unsigned int shifted_start = aug_state_start - g_aug_state_size;
+  EXPECT_EQ(ekf->GetAugStateStartIndex(1, 2), shifted_start);
+  EXPECT_EQ(ekf->GetCov()(shifted_start, shifted_start), 5.0);
+
+  // Unknown frames are ignored
+  ekf->RemoveAugmentedState(1, 7);
+  EXPECT_EQ(ekf->GetState().GetStateSize(), state_size - g_aug_state_size);
+}
+
+TEST(test_EKF, clone_headroom) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(debug_logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->SetMaxTrackLength(3U);
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Identity(6, 6));
+  ekf->RegisterCamera(2, CamState(), Eigen::MatrixXd::Identity(6, 6));
+  ekf->SetCloneHeadroom(2, 1U);
+  EXPECT_EQ(ekf->GetMaxCloneCount(1), 3U);
+  EXPECT_EQ(ekf->GetMaxCloneCount(2), 4U);
+
+  for (int frame_id = 0; frame_id < 6; ++frame_id) {
+    ekf->AugmentState(1, frame_id);
+    ekf->AugmentState(2, frame_id);
+  }
+  EXPECT_EQ(ekf->GetCamState(1).augmented_states.size(), 3U);
+  EXPECT_EQ(ekf->GetCamState(2).augmented_states.size(), 4U);
+  EXPECT_EQ(ekf->GetCamState(2).augmented_states.front().frame_id, 2);
+}
+
 ///
 /// @todo Write test with varying covariance in sensors
 ///
@@ -21,6 +21,8 @@
 #include <vector>
 
 #include "ekf/types.hpp"
+#include "utility/custom_assertions.hpp"
+#include "utility/math_helper.hpp"
 
 TEST(test_ekf_types, state_plus_equals_state) {
   Eigen::Quaterniond quat;
@@ -762,3 +764,28 @@ TEST(test_ekf_types, state_get_state_size) {
 
   EXPECT_EQ(state.GetStateSize(), 48U);
 }
+
+TEST(test_ekf_types, board_average) {
+  BoardAverage board_average;
+  std::vector<Eigen::Vector3d> positions {{1.0, 2.0, 3.0}, {3.0, 2.0, 1.0}, {2.0, 5.0, 2.0}};
+  std::vector<Eigen::Quaterniond> quaternions {
+    Eigen::Quaterniond(Eigen::AngleAxisd(0.10, Eigen::Vector3d::UnitZ())),
+    Eigen::Quaterniond(Eigen::AngleAxisd(0.20, Eigen::Vector3d::UnitZ())),
+    Eigen::Quaterniond(Eigen::AngleAxisd(0.30, Eigen::Vector3d::UnitZ()))};
+  // Same rotation with the opposite quaternion sign
+  quaternions[2].coeffs() *= -1.0;
+  std::vector<double> weights(3, 1.0);
+  for (unsigned int i = 0; i < positions.size(); ++i) {
+    board_average.Add(positions[i], quaternions[i]);
+  }
+  EXPECT_EQ(board_average.Size(), 3U);
+  EXPECT_TRUE(EXPECT_EIGEN_NEAR(
+      board_average.GetPosition(), average_vectors(positions, weights), 1e-12));
+  EXPECT_TRUE(EXPECT_EIGEN_NEAR(
+      board_average.GetOrientation(), average_quaternions(quaternions, weights), 1e-9));
+
+  board_average.Clear();
+  EXPECT_EQ(board_average.Size(), 0U);
+  board_average.Add(positions[0], quaternions[0]);
+  EXPECT_TRUE(EXPECT_EIGEN_NEAR(board_average.GetPosition(), positions[0], 1e-12));
+}
@@ -302,3 +302,51 @@ unsigned int State::GetStateSize()
   }
   return state_size;
 }
+
+void BoardAverage::Add(
+  const Eigen::Vector3d & pos_f_in_g, const Eigen::Quaterniond & ang_f_to_g,
+  double pos_weight, double ang_weight)
+{
+  m_pos_sum += pos_weight * pos_f_in_g;
+  m_pos_weight_sum += pos_weight;
+
+  Eigen::Vector4d ang_vec {ang_f_to_g.w(), ang_f_to_g.x(), ang_f_to_g.y(), ang_f_to_g.z()};
+  m_ang_accumulator += ang_weight * ang_weight * ang_vec * ang_vec.transpose();
+  ++m_size;
+}
+
+Eigen::Vector3d BoardAverage::GetPosition() const
+{
+  return m_pos_sum / m_pos_weight_sum;
+}
+
+Eigen::Quaterniond BoardAverage::GetOrientation() const
+{
+  Eigen::Quaterniond average_quaternion{1.0, 0.0, 0.0, 0.0};
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> eigen_solver(m_ang_accumulator);
+
+  if (eigen_solver.info() == Eigen::Success) {
+    // Eigenvalues are sorted in increasing order
+    Eigen::Vector4d eigen_vector = eigen_solver.eigenvectors().col(3);
+    average_quaternion.w() = eigen_vector(0);
+    average_quaternion.x() = eigen_vector(1);
+    average_quaternion.y() = eigen_vector(2);
+    average_quaternion.z() = eigen_vector(3);
+    average_quaternion.normalize();
+  }
+
+  return average_quaternion;
+}
+
+unsigned int BoardAverage::Size() const
+{
+  return m_size;
+}
+
+void BoardAverage::Clear()
+{
+  m_pos_sum.setZero();
+  m_pos_weight_sum = 0.0;
+  m_ang_accumulator.setZero();
+  m_size = 0U;
+}
@@ -121,10 +121,23 @@ typedef struct FeaturePoint
 {
   int frame_id;   ///< @brief Feature track frame ID
   cv::KeyPoint key_point;  ///< @brief Feature track key point
+  int camera_id {-1};  ///< @brief Observing camera ID. Negative for the track's own camera
 } FeaturePoint;
 
 typedef std::vector<std::vector<FeaturePoint>> FeatureTracks;
 
+///
+/// @brief Structure-of-arrays layout of all feature tracks used in a single update
+///
+typedef struct FeatureTrackBatch
+{
+  std::vector<double> u;                  ///< @brief Observation x pixel coordinates
+  std::vector<double> v;                  ///< @brief Observation y pixel coordinates
+  std::vector<unsigned int> clone_index;  ///< @brief Observation augmented state index
+  std::vector<unsigned int> track_start;  ///< @brief Index of first observation of each track
+  std::vector<unsigned int> track_size;   ///< @brief Observation count of each track
+} FeatureTrackBatch;
+
 ///
 /// @brief BoardDetection structure
 ///
@@ -133,10 +146,61 @@ typedef struct BoardDetection
   int frame_id;          ///< @brief Image frame ID
   cv::Vec3d t_vec_f_in_c;  ///< @brief Rotation vector of the board
   cv::Vec3d r_vec_f_to_c;  ///< @brief Translation vector of the board
+  unsigned int board_id {0U};  ///< @brief Board ID within the fiducial tracker
 } BoardDetection;
 
 typedef std::vector<BoardDetection> BoardTrack;
 
+///
+/// @class BoardAverage
+/// @brief Running weighted average of board poses in the global frame
+///
+class BoardAverage
+{
+public:
+  BoardAverage() {}
+
+  ///
+  /// @brief Add a board pose to the average
+  /// @param pos_f_in_g Board position in the global frame
+  /// @param ang_f_to_g Board orientation in the global frame
+  /// @param pos_weight Position weight
+  /// @param ang_weight Orientation weight
+  ///
+  void Add(
+    const Eigen::Vector3d & pos_f_in_g, const Eigen::Quaterniond & ang_f_to_g,
+    double pos_weight = 1.0, double ang_weight = 1.0);
+
+  ///
+  /// @brief Average position getter method
+  /// @return Weighted mean of the board positions
+  ///
+  Eigen::Vector3d GetPosition() const;
+
+  ///
+  /// @brief Average orientation getter method
+  /// @return Principal eigenvector of the quaternion outer-product accumulator
+  ///
+  Eigen::Quaterniond GetOrientation() const;
+
+  ///
+  /// @brief Board pose count getter method
+  /// @return Number of board poses in the average
+  ///
+  unsigned int Size() const;
+
+  ///
+  /// @brief Reset the average
+  ///
+  void Clear();
+
+private:
+  Eigen::Vector3d m_pos_sum {0.0, 0.0, 0.0};
+  double m_pos_weight_sum {0.0};
+  Eigen::Matrix4d m_ang_accumulator {Eigen::Matrix4d::Zero()};
+  unsigned int m_size {0U};
+};
+
 ///
 /// @class State
 /// @brief EKF State Class
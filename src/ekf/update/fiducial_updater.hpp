@@ -18,6 +18,7 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,8 +38,8 @@ public:
   ///
   /// @brief MSCKF EKF Updater constructor
   /// @param cam_id Camera sensor ID
-  /// @param fiducial_pos Fiducial position
-  /// @param fiducial_ang Fiducial orientation
+  /// @param fiducial_pos Position of the first board
+  /// @param fiducial_ang Orientation of the first board
   /// @param log_file_directory Directory to save log files
   /// @param data_logging_on Flag to enable data logging
   /// @param data_log_rate Maximum average rate to log data
@@ -62,9 +63,42 @@ public:
   ///
   void UpdateEKF(
     std::shared_ptr<EKF> ekf,
-    double time, BoardTrack board_track, double pos_error, double ang_error);
+    double time, const BoardTrack & board_track, double pos_error, double ang_error);
+
+  ///
+  /// @brief EKF updater function stacking the tracks of several boards into a single update
+  ///
+  /// Board poses are averaged from the augmented state estimates at update time.
+  /// @param time Time of update
+  /// @param board_tracks Board tracks to be used for state update, one per board
+  /// @param pos_error Standard deviation of the position error
+  /// @param ang_error Standard deviation of the angle error
+  ///
+  void UpdateEKF(
+    std::shared_ptr<EKF> ekf, double time,
+    const std::vector<BoardTrack> & board_tracks, double pos_error, double ang_error);
+
+  ///
+  /// @brief Set the prior pose of a board
+  /// @param board_id Board ID within the fiducial tracker
+  /// @param pos_f_in_g Board position
+  /// @param ang_f_to_g Board orientation
+  ///
+  void SetBoardPose(
+    unsigned int board_id, Eigen::Vector3d pos_f_in_g, Eigen::Quaterniond ang_f_to_g);
 
 private:
+  ///
+  /// @brief Add a board detection to a running board pose average
+  /// @param ekf EKF pointer
+  /// @param time Time of detection
+  /// @param board_detection Board detection with a matching augmented state
+  /// @param board_average Running average of board poses in the global frame
+  ///
+  void AddDetection(
+    std::shared_ptr<EKF> ekf, double time,
+    const BoardDetection & board_detection, BoardAverage & board_average);
+
   Eigen::Vector3d m_body_pos {0.0, 0.0, 0.0};
   Eigen::Vector3d m_body_vel {0.0, 0.0, 0.0};
   Eigen::Vector3d m_body_acc {0.0, 0.0, 0.0};
@@ -75,8 +109,11 @@ private:
   Eigen::Vector3d m_pos_c_in_b {0.0, 0.0, 0.0};
   Eigen::Quaterniond m_ang_c_to_b {1.0, 0.0, 0.0, 0.0};
 
-  Eigen::Vector3d m_pos_f_in_g;
-  Eigen::Quaterniond m_ang_f_to_g;
+  std::map<unsigned int, Eigen::Vector3d> m_pos_f_in_g;
+  std::map<unsigned int, Eigen::Quaterniond> m_ang_f_to_g;
+
+  Eigen::VectorXd m_res_f;
+  Eigen::MatrixXd m_H_c;
 
   DataLogger m_fiducial_logger;
   DataLogger m_triangulation_logger;
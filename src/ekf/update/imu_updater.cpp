@@ -243,26 +243,27 @@ void ImuUpdater::UpdateEKF(
   auto t_execution = std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start);
 
   // Write outputs
-  std::stringstream msg;
-
-  msg << time;
-  msg << VectorToCommaString(ekf->GetState().m_imu_states[m_id].pos_i_in_b);
-  msg << QuaternionToCommaString(ekf->GetState().m_imu_states[m_id].ang_i_to_b);
-  msg << VectorToCommaString(ekf->GetState().m_imu_states[m_id].acc_bias);
-  msg << VectorToCommaString(ekf->GetState().m_imu_states[m_id].omg_bias);
+  if (!m_data_logger.IsLogDue(time)) {
+    return;
+  }
+  DataRecord & record = m_data_logger.NewRecord();
+  record.Append(time);
+  record.Append(ekf->GetState().m_imu_states[m_id].pos_i_in_b);
+  record.Append(ekf->GetState().m_imu_states[m_id].ang_i_to_b);
+  record.Append(ekf->GetState().m_imu_states[m_id].acc_bias);
+  record.Append(ekf->GetState().m_imu_states[m_id].omg_bias);
   if (imu_update_size) {
-    Eigen::VectorXd cov_diag = ekf->GetCov().block(
-      imu_state_start, imu_state_start, imu_update_size, imu_update_size).diagonal();
-    msg << VectorToCommaString(cov_diag);
+    record.Append(
+      ekf->GetCov().block(
+        imu_state_start, imu_state_start, imu_update_size, imu_update_size).diagonal());
   }
-  msg << VectorToCommaString(acceleration);
-  msg << VectorToCommaString(angular_rate);
-  msg << VectorToCommaString(resid);
-  msg << VectorToCommaString(body_update);
+  record.Append(acceleration);
+  record.Append(angular_rate);
+  record.Append(resid);
+  record.Append(body_update);
   if (imu_update_size) {
-    Eigen::VectorXd imu_sub_update = update.segment(imu_state_start, imu_update_size);
-    msg << VectorToCommaString(imu_sub_update);
+    record.Append(update.segment(imu_state_start, imu_update_size));
   }
-  msg << "," << t_execution.count();
-  m_data_logger.RateLimitedLog(msg.str(), time);
+  record.Append(t_execution.count());
+  m_data_logger.LogRecord();
 }
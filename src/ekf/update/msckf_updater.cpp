@@ -17,13 +17,16 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <iomanip>
+#include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include <opencv2/opencv.hpp>
 
@@ -56,6 +59,7 @@ MsckfUpdater::MsckfUpdater(
   header << EnumerateHeader("cam_update", g_cam_state_size);
   header << EnumerateHeader("cam_cov", g_cam_state_size);
   header << ",FeatureTracks";
+  header << ",RejectedTracks";
   header << EnumerateHeader("duration", 1);
 
   m_msckf_logger.DefineHeader(header.str());
@@ -64,6 +68,7 @@ MsckfUpdater::MsckfUpdater(
   m_triangulation_logger.DefineHeader("time,feature,x,y,z");
   m_triangulation_logger.SetLogging(data_logging_on);
   m_triangulation_logger.SetLogRate(data_log_rate);
+  m_triangulation_logger.SetPrecision(3U);
 
   m_intrinsics = intrinsics;
   m_min_feat_dist = min_feat_dist;
@@ -71,9 +76,10 @@ MsckfUpdater::MsckfUpdater(
 
 Eigen::Vector3d MsckfUpdater::TriangulateFeature(
   std::shared_ptr<EKF> ekf,
-  std::vector<FeaturePoint> & feature_track)
+  const std::vector<FeaturePoint> & feature_track)
 {
-  AugmentedState aug_state_0 = ekf->MatchState(m_id, feature_track[0].frame_id);
+  AugmentedState aug_state_0 =
+    ekf->MatchState(ObservingCamera(feature_track[0]), feature_track[0].frame_id);
 
   // 3D Cartesian Triangulation
   Eigen::Matrix3d A = Eigen::Matrix3d::Zero();
@@ -88,7 +94,8 @@ Eigen::Vector3d MsckfUpdater::TriangulateFeature(
   const Eigen::Matrix3d rotation_i0_to_c0 = rotation_c0_to_i0.transpose();
 
   for (unsigned int i = 0; i < feature_track.size(); ++i) {
-    AugmentedState aug_state_i = ekf->MatchState(m_id, feature_track[i].frame_id);
+    AugmentedState aug_state_i =
+      ekf->MatchState(ObservingCamera(feature_track[i]), feature_track[i].frame_id);
 
     const Eigen::Vector3d position_bi_in_g = aug_state_i.pos_b_in_g;
     const Eigen::Matrix3d rotation_bi_to_g = aug_state_i.ang_b_to_g.toRotationMatrix();
@@ -134,6 +141,347 @@ Eigen::Vector3d MsckfUpdater::TriangulateFeature(
   return position_f_in_g;
 }
 
+Eigen::Vector3d MsckfUpdater::TriangulateFeatureLOST(
+  std::shared_ptr<EKF> ekf,
+  const std::vector<FeaturePoint> & feature_track)
+{
+  unsigned int track_size = feature_track.size();
+  std::vector<Eigen::Matrix3d> rot_ci_to_g(track_size);
+  std::vector<Eigen::Vector3d> pos_ci_in_g(track_size);
+  std::vector<Eigen::Vector3d> uv_ci(track_size);
+
+  for (unsigned int i = 0; i < track_size; ++i) {
+    AugmentedState aug_state_i =
+      ekf->MatchState(ObservingCamera(feature_track[i]), feature_track[i].frame_id);
+    Eigen::Matrix3d rot_bi_to_g = aug_state_i.ang_b_to_g.toRotationMatrix();
+    rot_ci_to_g[i] = rot_bi_to_g * aug_state_i.ang_c_to_b.toRotationMatrix();
+    pos_ci_in_g[i] = rot_bi_to_g * aug_state_i.pos_c_in_b + aug_state_i.pos_b_in_g;
+
+    // Homogeneous normalized coordinates
+    double half_width = static_cast<double>(m_intrinsics.width) / 2;
+    double half_height = static_cast<double>(m_intrinsics.height) / 2;
+    uv_ci[i](0) = (feature_track[i].key_point.pt.x - half_width) /
+      (m_intrinsics.f_x / m_intrinsics.pixel_size);
+    uv_ci[i](1) = (feature_track[i].key_point.pt.y - half_height) /
+      (m_intrinsics.f_y / m_intrinsics.pixel_size);
+    uv_ci[i](2) = 1;
+  }
+
+  // Stack the sine-weighted linear system relative to the first camera position
+  Eigen::MatrixXd A = Eigen::MatrixXd::Zero(2 * track_size, 3);
+  Eigen::VectorXd b = Eigen::VectorXd::Zero(2 * track_size);
+  for (unsigned int i = 0; i < track_size; ++i) {
+    // Pair each observation with the one of longest baseline
+    unsigned int j = (i + 1) % track_size;
+    for (unsigned int k = 0; k < track_size; ++k) {
+      if ((pos_ci_in_g[k] - pos_ci_in_g[i]).squaredNorm() >
+        (pos_ci_in_g[j] - pos_ci_in_g[i]).squaredNorm())
+      {
+        j = k;
+      }
+    }
+    Eigen::Vector3d baseline_in_g = pos_ci_in_g[j] - pos_ci_in_g[i];
+    Eigen::Vector3d uv_ci_in_g = rot_ci_to_g[i] * uv_ci[i];
+    Eigen::Vector3d uv_cj_in_g = rot_ci_to_g[j] * uv_ci[j];
+
+    // Weight is proportional to the inverse range given by the law of sines
+    double q_i = uv_ci_in_g.cross(uv_cj_in_g).norm() /
+      std::max(baseline_in_g.cross(uv_cj_in_g).norm(), 1e-12);
+
+    Eigen::Matrix<double, 2, 3> coefficients =
+      q_i * SkewSymmetric(uv_ci[i]).topRows<2>() * rot_ci_to_g[i].transpose();
+    A.block<2, 3>(2 * i, 0) = coefficients;
+    b.segment<2>(2 * i) = coefficients * (pos_ci_in_g[i] - pos_ci_in_g[0]);
+  }
+
+  Eigen::Vector3d position_f_in_c0 = A.colPivHouseholderQr().solve(b);
+
+  return position_f_in_c0 + pos_ci_in_g[0];
+}
+
+FeatureTrackBatch MsckfUpdater::CreateTrackBatch(
+  std::shared_ptr<EKF> ekf,
+  const FeatureTracks & feature_tracks)
+{
+  std::vector<unsigned int> track_indices(feature_tracks.size());
+  std::iota(track_indices.begin(), track_indices.end(), 0U);
+  return CreateTrackBatch(ekf, feature_tracks, track_indices);
+}
+
+FeatureTrackBatch MsckfUpdater::CreateTrackBatch(
+  std::shared_ptr<EKF> ekf,
+  const FeatureTracks & feature_tracks,
+  const std::vector<unsigned int> & track_indices)
+{
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(m_id).augmented_states;
+  std::map<int, unsigned int> clone_map;
+  for (unsigned int i = 0; i < aug_states.size(); ++i) {
+    clone_map[aug_states[i].frame_id] = i;
+  }
+
+  unsigned int observation_count {0};
+  for (auto track_index : track_indices) {
+    observation_count += feature_tracks[track_index].size();
+  }
+
+  FeatureTrackBatch track_batch;
+  track_batch.u.reserve(observation_count);
+  track_batch.v.reserve(observation_count);
+  track_batch.clone_index.reserve(observation_count);
+  track_batch.track_start.reserve(track_indices.size());
+  track_batch.track_size.reserve(track_indices.size());
+
+  for (auto track_index : track_indices) {
+    auto const & feature_track = feature_tracks[track_index];
+    track_batch.track_start.push_back(track_batch.u.size());
+    track_batch.track_size.push_back(feature_track.size());
+    for (auto const & feature_point : feature_track) {
+      auto clone_iter = clone_map.find(feature_point.frame_id);
+      if (clone_iter != clone_map.end()) {
+        track_batch.clone_index.push_back(clone_iter->second);
+      } else if (ObservingCamera(feature_point) != m_id) {
+        // Observations from other cameras are triangulated per track by the caller
+        track_batch.clone_index.push_back(aug_states.size());
+      } else {
+        // Index past the last clone refers to a default state, as with EKF::MatchState
+        std::stringstream warning_msg;
+        warning_msg << "No matching augmented state for frame " << feature_point.frame_id;
+        m_logger->Log(LogLevel::WARN, warning_msg.str());
+        track_batch.clone_index.push_back(aug_states.size());
+      }
+      track_batch.u.push_back(feature_point.key_point.pt.x);
+      track_batch.v.push_back(feature_point.key_point.pt.y);
+    }
+  }
+
+  return track_batch;
+}
+
+std::vector<Eigen::Vector3d> MsckfUpdater::TriangulateFeatures(
+  std::shared_ptr<EKF> ekf,
+  const FeatureTrackBatch & track_batch)
+{
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(m_id).augmented_states;
+  aug_states.push_back(AugmentedState());
+
+  // Camera poses in the global frame are computed once per clone instead of once per observation
+  unsigned int clone_count = aug_states.size();
+  Eigen::Matrix<double, 9, Eigen::Dynamic> rot_c_to_g(9, clone_count);
+  Eigen::Matrix<double, 3, Eigen::Dynamic> pos_c_in_g(3, clone_count);
+  for (unsigned int j = 0; j < clone_count; ++j) {
+    Eigen::Matrix3d rot_bj_to_g = aug_states[j].ang_b_to_g.toRotationMatrix();
+    Eigen::Matrix3d rot_cj_to_g = rot_bj_to_g * aug_states[j].ang_c_to_b.toRotationMatrix();
+    rot_c_to_g.col(j) = Eigen::Map<Eigen::Matrix<double, 9, 1>>(rot_cj_to_g.data());
+    pos_c_in_g.col(j) = rot_bj_to_g * aug_states[j].pos_c_in_b + aug_states[j].pos_b_in_g;
+  }
+
+  // Gather clone rotations and anchor-relative positions into contiguous observation columns
+  Eigen::Index obs_count = track_batch.u.size();
+  Eigen::Array<double, Eigen::Dynamic, 9> rot_obs(obs_count, 9);
+  Eigen::Array<double, Eigen::Dynamic, 3> pos_obs(obs_count, 3);
+  for (unsigned int t = 0; t < track_batch.track_start.size(); ++t) {
+    unsigned int start = track_batch.track_start[t];
+    unsigned int anchor = track_batch.clone_index[start];
+    for (unsigned int k = start; k < start + track_batch.track_size[t]; ++k) {
+      unsigned int clone = track_batch.clone_index[k];
+      rot_obs.row(k) = rot_c_to_g.col(clone).transpose().array();
+      pos_obs.row(k) = (pos_c_in_g.col(clone) - pos_c_in_g.col(anchor)).transpose().array();
+    }
+  }
+
+  // Bearing vectors for all observations, vectorized across tracks
+  Eigen::Map<const Eigen::ArrayXd> u_px(track_batch.u.data(), obs_count);
+  Eigen::Map<const Eigen::ArrayXd> v_px(track_batch.v.data(), obs_count);
+  Eigen::ArrayXd x_norm = (u_px - (static_cast<double>(m_intrinsics.width) / 2)) /
+    (m_intrinsics.f_x / m_intrinsics.pixel_size);
+  Eigen::ArrayXd y_norm = (v_px - (static_cast<double>(m_intrinsics.height) / 2)) /
+    (m_intrinsics.f_y / m_intrinsics.pixel_size);
+
+  Eigen::ArrayXd b_x = rot_obs.col(0) * x_norm + rot_obs.col(3) * y_norm + rot_obs.col(6);
+  Eigen::ArrayXd b_y = rot_obs.col(1) * x_norm + rot_obs.col(4) * y_norm + rot_obs.col(7);
+  Eigen::ArrayXd b_z = rot_obs.col(2) * x_norm + rot_obs.col(5) * y_norm + rot_obs.col(8);
+  Eigen::ArrayXd b_inv_norm = (b_x.square() + b_y.square() + b_z.square()).sqrt().inverse();
+  b_x *= b_inv_norm;
+  b_y *= b_inv_norm;
+  b_z *= b_inv_norm;
+
+  // Unique entries of the normal matrix A_i = [b_i]x^T [b_i]x = I - b_i b_i^T
+  Eigen::ArrayXd a_xx = 1.0 - b_x.square();
+  Eigen::ArrayXd a_yy = 1.0 - b_y.square();
+  Eigen::ArrayXd a_zz = 1.0 - b_z.square();
+  Eigen::ArrayXd a_xy = -b_x * b_y;
+  Eigen::ArrayXd a_xz = -b_x * b_z;
+  Eigen::ArrayXd a_yz = -b_y * b_z;
+  Eigen::ArrayXd r_x = a_xx * pos_obs.col(0) + a_xy * pos_obs.col(1) + a_xz * pos_obs.col(2);
+  Eigen::ArrayXd r_y = a_xy * pos_obs.col(0) + a_yy * pos_obs.col(1) + a_yz * pos_obs.col(2);
+  Eigen::ArrayXd r_z = a_xz * pos_obs.col(0) + a_yz * pos_obs.col(1) + a_zz * pos_obs.col(2);
+
+  // Accumulate and solve the linear triangulation of each track
+  std::vector<Eigen::Vector3d> positions_f_in_g;
+  positions_f_in_g.reserve(track_batch.track_start.size());
+  for (unsigned int t = 0; t < track_batch.track_start.size(); ++t) {
+    unsigned int start = track_batch.track_start[t];
+    unsigned int size = track_batch.track_size[t];
+
+    Eigen::Matrix3d A;
+    A(0, 0) = a_xx.segment(start, size).sum();
+    A(1, 1) = a_yy.segment(start, size).sum();
+    A(2, 2) = a_zz.segment(start, size).sum();
+    A(0, 1) = A(1, 0) = a_xy.segment(start, size).sum();
+    A(0, 2) = A(2, 0) = a_xz.segment(start, size).sum();
+    A(1, 2) = A(2, 1) = a_yz.segment(start, size).sum();
+
+    Eigen::Vector3d b;
+    b(0) = r_x.segment(start, size).sum();
+    b(1) = r_y.segment(start, size).sum();
+    b(2) = r_z.segment(start, size).sum();
+
+    Eigen::Vector3d position_f_in_c0 = A.colPivHouseholderQr().solve(b);
+    positions_f_in_g.push_back(
+      pos_c_in_g.col(track_batch.clone_index[start]) + position_f_in_c0);
+  }
+
+  return positions_f_in_g;
+}
+
+unsigned int MsckfUpdater::ObservingCamera(const FeaturePoint & feature_point) const
+{
+  if (feature_point.camera_id < 0) {
+    return m_id;
+  }
+  return static_cast<unsigned int>(feature_point.camera_id);
+}
+
+bool MsckfUpdater::IsMultiCameraTrack(const std::vector<FeaturePoint> & feature_track) const
+{
+  for (auto const & feature_point : feature_track) {
+    if (ObservingCamera(feature_point) != m_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MsckfUpdater::HasAllClones(
+  std::shared_ptr<EKF> ekf,
+  const std::vector<FeaturePoint> & feature_track) const
+{
+  for (auto const & feature_point : feature_track) {
+    if (!ekf->HasAugmentedState(ObservingCamera(feature_point), feature_point.frame_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MsckfUpdater::SetBatchTriangulation(bool batch_triangulation)
+{
+  m_batch_triangulation = batch_triangulation;
+}
+
+void MsckfUpdater::SetTriangulationMethod(TriangulationMethod triangulation_method)
+{
+  m_triangulation_method = triangulation_method;
+}
+
+void MsckfUpdater::SetUpdateBudget(unsigned int max_update_rows, double max_update_time)
+{
+  m_max_update_rows = max_update_rows;
+  m_max_update_time = max_update_time;
+}
+
+std::vector<unsigned int> MsckfUpdater::SelectFeatureTracks(
+  std::shared_ptr<EKF> ekf,
+  const FeatureTracks & feature_tracks,
+  const std::vector<Eigen::Vector3d> & positions_f_in_g)
+{
+  std::vector<unsigned int> candidate_indices(feature_tracks.size());
+  std::iota(candidate_indices.begin(), candidate_indices.end(), 0U);
+  return SelectFeatureTracks(ekf, feature_tracks, candidate_indices, positions_f_in_g);
+}
+
+std::vector<unsigned int> MsckfUpdater::SelectFeatureTracks(
+  std::shared_ptr<EKF> ekf,
+  const FeatureTracks & feature_tracks,
+  const std::vector<unsigned int> & candidate_indices,
+  const std::vector<Eigen::Vector3d> & positions_f_in_g)
+{
+  std::vector<unsigned int> track_indices;
+  std::vector<double> track_scores(feature_tracks.size(), 0.0);
+
+  for (auto track_index : candidate_indices) {
+    const auto & feature_track = feature_tracks[track_index];
+    const Eigen::Vector3d & pos_f_in_g = positions_f_in_g[track_index];
+
+    if (pos_f_in_g.norm() < m_min_feat_dist) {
+      std::stringstream err_msg;
+      err_msg << "MSCKF Triangulated Point is too close. r = " << pos_f_in_g.norm();
+      m_logger->Log(LogLevel::INFO, err_msg.str());
+      continue;
+    }
+
+    // Parallax from the first and last camera positions against feature range
+    AugmentedState aug_state_0 =
+      ekf->MatchState(ObservingCamera(feature_track.front()), feature_track.front().frame_id);
+    AugmentedState aug_state_n =
+      ekf->MatchState(ObservingCamera(feature_track.back()), feature_track.back().frame_id);
+    Eigen::Vector3d pos_c0_in_g =
+      aug_state_0.ang_b_to_g * aug_state_0.pos_c_in_b + aug_state_0.pos_b_in_g;
+    Eigen::Vector3d pos_cn_in_g =
+      aug_state_n.ang_b_to_g * aug_state_n.pos_c_in_b + aug_state_n.pos_b_in_g;
+    double range = std::max((pos_f_in_g - pos_c0_in_g).norm(), 1e-9);
+    double parallax = (pos_cn_in_g - pos_c0_in_g).norm() / range;
+
+    // Tracks with more parallax and more observations are better conditioned
+    track_scores[track_index] = parallax * static_cast<double>(feature_track.size());
+    track_indices.push_back(track_index);
+  }
+
+  if ((m_max_update_rows == 0) && (m_max_update_time <= 0.0)) {
+    return track_indices;
+  }
+
+  // Row limit from the configured maximum and the measured cost per row
+  unsigned int max_rows = std::numeric_limits<unsigned int>::max();
+  if (m_max_update_rows > 0) {
+    max_rows = m_max_update_rows;
+  }
+  if ((m_max_update_time > 0.0) && (m_row_update_time > 0.0)) {
+    double time_rows = m_max_update_time / m_row_update_time;
+    if (time_rows < static_cast<double>(max_rows)) {
+      max_rows = static_cast<unsigned int>(time_rows);
+    }
+  }
+
+  std::stable_sort(
+    track_indices.begin(), track_indices.end(),
+    [&track_scores](unsigned int a, unsigned int b) {
+      return track_scores[a] > track_scores[b];
+    });
+
+  // Each track contributes 2N - 3 rows after nullspace projection
+  std::vector<unsigned int> selected_indices;
+  unsigned int row_count {0U};
+  for (auto track_index : track_indices) {
+    unsigned int track_size = feature_tracks[track_index].size();
+    unsigned int track_rows = (track_size > 1) ? (2 * track_size - 3) : 0;
+    // Always keep the best track so the update and its timing estimate continue
+    if (!selected_indices.empty() && (row_count + track_rows > max_rows)) {
+      continue;
+    }
+    row_count += track_rows;
+    selected_indices.push_back(track_index);
+  }
+
+  if (selected_indices.size() < track_indices.size()) {
+    m_logger->Log(
+      LogLevel::DEBUG, "MSCKF budget dropped " +
+      std::to_string(track_indices.size() - selected_indices.size()) + " tracks");
+  }
+
+  return selected_indices;
+}
+
 void MsckfUpdater::projection_jacobian(const Eigen::Vector3d & position, Eigen::MatrixXd & jacobian)
 {
   // Normalized coordinates in respect to projection function
@@ -198,10 +546,28 @@ void MsckfUpdater::distortion_jacobian(
 void MsckfUpdater::UpdateEKF(
   std::shared_ptr<EKF> ekf,
   double time,
-  FeatureTracks feature_tracks,
-  double px_error)
+  const FeatureTracks & feature_tracks,
+  double px_error,
+  bool predict)
 {
-  ekf->ProcessModel(time);
+  if (predict) {
+    ekf->ProcessModel(time);
+  }
+
+  // Tracks observed in marginalized clones cannot be linearized and are skipped
+  std::vector<unsigned int> valid_indices;
+  valid_indices.reserve(feature_tracks.size());
+  for (unsigned int i = 0; i < feature_tracks.size(); ++i) {
+    if (HasAllClones(ekf, feature_tracks[i])) {
+      valid_indices.push_back(i);
+    }
+  }
+  if (valid_indices.size() < feature_tracks.size()) {
+    m_logger->Log(
+      LogLevel::DEBUG, "MSCKF skipped " +
+      std::to_string(feature_tracks.size() - valid_indices.size()) +
+      " tracks with marginalized clones");
+  }
 
   BodyState body_state = ekf->GetBodyState();
   m_body_pos = body_state.m_position;
@@ -220,14 +586,14 @@ void MsckfUpdater::UpdateEKF(
 
   m_logger->Log(LogLevel::DEBUG, "Called update_msckf for camera ID: " + std::to_string(m_id));
 
-  if (feature_tracks.size() == 0) {
+  if (valid_indices.size() == 0) {
     return;
   }
 
   // Calculate the max possible measurement size
   unsigned int max_meas_size = 0;
-  for (unsigned int i = 0; i < feature_tracks.size(); ++i) {
-    max_meas_size += 2 * feature_tracks[i].size();
+  for (auto track_index : valid_indices) {
+    max_meas_size += 2 * feature_tracks[track_index].size();
   }
 
   unsigned int ct_meas = 0;
@@ -237,41 +603,76 @@ void MsckfUpdater::UpdateEKF(
   Eigen::VectorXd res_x = Eigen::VectorXd::Zero(max_meas_size);
   Eigen::MatrixXd H_x = Eigen::MatrixXd::Zero(max_meas_size, state_size);
 
-  m_logger->Log(LogLevel::DEBUG, "Update track count: " + std::to_string(feature_tracks.size()));
+  m_logger->Log(LogLevel::DEBUG, "Update track count: " + std::to_string(valid_indices.size()));
+
+  // Get triangulated estimates of feature positions, indexed as the feature tracks
+  std::vector<Eigen::Vector3d> positions_f_in_g(feature_tracks.size(), Eigen::Vector3d::Zero());
+  if (m_triangulation_method == TriangulationMethod::LOST) {
+    for (auto track_index : valid_indices) {
+      positions_f_in_g[track_index] = TriangulateFeatureLOST(ekf, feature_tracks[track_index]);
+    }
+  } else if (m_batch_triangulation) {
+    std::vector<Eigen::Vector3d> batch_positions =
+      TriangulateFeatures(ekf, CreateTrackBatch(ekf, feature_tracks, valid_indices));
+    for (unsigned int i = 0; i < valid_indices.size(); ++i) {
+      // The batch only holds clones of this camera, so multi-camera tracks are redone per track
+      const auto & feature_track = feature_tracks[valid_indices[i]];
+      if (IsMultiCameraTrack(feature_track)) {
+        positions_f_in_g[valid_indices[i]] = TriangulateFeature(ekf, feature_track);
+      } else {
+        positions_f_in_g[valid_indices[i]] = batch_positions[i];
+      }
+    }
+  } else {
+    for (auto track_index : valid_indices) {
+      positions_f_in_g[track_index] = TriangulateFeature(ekf, feature_tracks[track_index]);
+    }
+  }
+
+  // Select the most informative tracks within the update budget
+  std::vector<unsigned int> track_indices =
+    SelectFeatureTracks(ekf, feature_tracks, valid_indices, positions_f_in_g);
 
   // MSCKF Update
-  for (auto & feature_track : feature_tracks) {
+  unsigned int rejected_tracks {0U};
+  for (auto track_index : track_indices) {
+    auto & feature_track = feature_tracks[track_index];
     m_logger->Log(LogLevel::DEBUG, "Feature Track size: " + std::to_string(feature_track.size()));
 
-    // Get triangulated estimate of feature position
-    Eigen::Vector3d pos_f_in_g = TriangulateFeature(ekf, feature_track);
+    Eigen::Vector3d pos_f_in_g = positions_f_in_g[track_index];
 
     /// @todo Additional non-linear optimization
 
-    if (pos_f_in_g.norm() < m_min_feat_dist) {
-      std::stringstream err_msg;
-      err_msg << "MSCKF Triangulated Point is too close. r = " << pos_f_in_g.norm();
-      m_logger->Log(LogLevel::INFO, err_msg.str());
-      continue;
+    if (m_triangulation_logger.IsLogDue(time)) {
+      DataRecord & record = m_triangulation_logger.NewRecord();
+      record.Append(time);
+      record.Append(feature_track[0].key_point.class_id);
+      record.Append(pos_f_in_g);
+      m_triangulation_logger.LogRecord();
     }
 
-    std::stringstream msg;
-    msg << std::setprecision(3) << time;
-    msg << "," << std::to_string(feature_track[0].key_point.class_id);
-    msg << "," << pos_f_in_g[0];
-    msg << "," << pos_f_in_g[1];
-    msg << "," << pos_f_in_g[2];
-    m_triangulation_logger.RateLimitedLog(msg.str(), time);
+    // Camera state columns spanned by every camera observing this track
+    unsigned int cols_start = cam_state_start;
+    unsigned int cols_end = cam_state_start + g_cam_state_size +
+      g_aug_state_size * ekf->GetCamState(m_id).augmented_states.size();
+    if (IsMultiCameraTrack(feature_track)) {
+      for (auto const & feature_point : feature_track) {
+        unsigned int obs_cam_id = ObservingCamera(feature_point);
+        unsigned int obs_cam_start = ekf->GetCamStateStartIndex(obs_cam_id);
+        unsigned int obs_cam_end = obs_cam_start + g_cam_state_size +
+          g_aug_state_size * ekf->GetCamState(obs_cam_id).augmented_states.size();
+        cols_start = std::min(cols_start, obs_cam_start);
+        cols_end = std::max(cols_end, obs_cam_end);
+      }
+    }
 
-    unsigned int aug_state_size = g_aug_state_size *
-      ekf->GetCamState(m_id).augmented_states.size();
     Eigen::VectorXd res_f = Eigen::VectorXd::Zero(2 * feature_track.size());
     Eigen::MatrixXd H_f = Eigen::MatrixXd::Zero(2 * feature_track.size(), 3);
-    Eigen::MatrixXd H_c = Eigen::MatrixXd::Zero(
-      2 * feature_track.size(), g_cam_state_size + aug_state_size);
+    Eigen::MatrixXd H_c = Eigen::MatrixXd::Zero(2 * feature_track.size(), cols_end - cols_start);
 
     for (unsigned int i = 0; i < feature_track.size(); ++i) {
-      AugmentedState aug_state_i = ekf->MatchState(m_id, feature_track[i].frame_id);
+      unsigned int obs_cam_id = ObservingCamera(feature_track[i]);
+      AugmentedState aug_state_i = ekf->MatchState(obs_cam_id, feature_track[i].frame_id);
 
       Eigen::Matrix3d rot_ci_to_bi = aug_state_i.ang_c_to_b.toRotationMatrix();
       Eigen::Matrix3d rot_bi_to_g = aug_state_i.ang_b_to_g.toRotationMatrix();
@@ -294,7 +695,8 @@ void MsckfUpdater::UpdateEKF(
       xz_residual = xz_measured - xz_predicted;
       res_f.segment<2>(2 * i) = xz_residual;
 
-      unsigned int aug_state_start = ekf->GetAugStateStartIndex(m_id, feature_track[i].frame_id);
+      unsigned int aug_state_start =
+        ekf->GetAugStateStartIndex(obs_cam_id, feature_track[i].frame_id);
 
       // Projection Jacobian
       Eigen::MatrixXd H_p(2, 3);
@@ -316,20 +718,34 @@ void MsckfUpdater::UpdateEKF(
       // H_t.block<3, 3>(0, 9) =
       //   SkewSymmetric(rot_bi_to_ci * rot_bi_to_g.transpose() * (pos_f_in_g - pos_bi_in_g));
 
-      H_c.block<2, 12>(2 * i, aug_state_start - cam_state_start) = H_d * H_p * H_t;
+      H_c.block<2, 12>(2 * i, aug_state_start - cols_start) = H_d * H_p * H_t;
     }
     ApplyLeftNullspace(H_f, H_c, res_f);
 
-    /// @todo Chi^2 distance check
+    // Gate track before it enters the stacked update
+    Eigen::MatrixXd P_c = ekf->GetCov().block(cols_start, cols_start, H_c.cols(), H_c.cols());
+    if (!ChiSquaredTest(H_c, P_c, res_f, px_error * px_error)) {
+      m_logger->Log(
+        LogLevel::DEBUG, "MSCKF track rejected by chi-squared test: " +
+        std::to_string(feature_track[0].key_point.class_id));
+      ++rejected_tracks;
+      continue;
+    }
 
     // Append Jacobian and residual
-    H_x.block(ct_meas, cam_state_start, H_c.rows(), H_c.cols()) = H_c;
+    H_x.block(ct_meas, cols_start, H_c.rows(), H_c.cols()) = H_c;
     res_x.block(ct_meas, 0, res_f.rows(), 1) = res_f;
 
     ct_meas += H_c.rows();
   }
 
+  // Frames without an applied update are still logged, so fully gated frames remain visible
   if (ct_meas == 0) {
+    auto t_execution = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::high_resolution_clock::now() - t_start);
+    LogUpdate(
+      ekf, time, Eigen::VectorXd::Zero(g_body_state_size), Eigen::VectorXd::Zero(g_cam_state_size),
+      valid_indices.size(), rejected_tracks, t_execution);
     return;
   }
 
@@ -338,6 +754,11 @@ void MsckfUpdater::UpdateEKF(
   // Jacobian is ill-formed if either rows or columns post-compression are size 1
   if (res_x.size() == 1) {
     m_logger->Log(LogLevel::INFO, "Compressed MSCKF Jacobian is ill-formed");
+    auto t_execution = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::high_resolution_clock::now() - t_start);
+    LogUpdate(
+      ekf, time, Eigen::VectorXd::Zero(g_body_state_size), Eigen::VectorXd::Zero(g_cam_state_size),
+      valid_indices.size(), rejected_tracks, t_execution);
     return;
   }
 
@@ -367,22 +788,44 @@ void MsckfUpdater::UpdateEKF(
   auto t_end = std::chrono::high_resolution_clock::now();
   auto t_execution = std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start);
 
-  // Write outputs
+  // Running estimate of update time per measurement row for the time budget
+  double row_update_time = static_cast<double>(t_execution.count()) * 1e-6 / ct_meas;
+  if (m_row_update_time > 0.0) {
+    m_row_update_time = 0.9 * m_row_update_time + 0.1 * row_update_time;
+  } else {
+    m_row_update_time = row_update_time;
+  }
+
+  LogUpdate(
+    ekf, time, body_update, cam_update, valid_indices.size(), rejected_tracks, t_execution);
+}
+
+void MsckfUpdater::LogUpdate(
+  std::shared_ptr<EKF> ekf,
+  double time,
+  const Eigen::VectorXd & body_update,
+  const Eigen::VectorXd & cam_update,
+  unsigned int track_count,
+  unsigned int rejected_tracks,
+  std::chrono::microseconds t_execution)
+{
+  if (!m_msckf_logger.IsLogDue(time)) {
+    return;
+  }
+  unsigned int cam_state_start = ekf->GetCamStateStartIndex(m_id);
   Eigen::VectorXd cam_state_vec = ekf->GetState().m_cam_states[m_id].ToVector();
-  Eigen::Vector3d cam_pos = cam_state_vec.segment<3>(0);
-  Eigen::Quaterniond cam_ang_pos = RotVecToQuat(cam_state_vec.segment<3>(3));
-  Eigen::VectorXd cam_sub_update = update.segment(cam_state_start, g_cam_state_size);
-  Eigen::VectorXd cov_diag = ekf->GetCov().block(
-    cam_state_start, cam_state_start, g_cam_state_size, g_cam_state_size).diagonal();
-
-  std::stringstream msg;
-  msg << time;
-  msg << VectorToCommaString(cam_pos);
-  msg << QuaternionToCommaString(cam_ang_pos);
-  msg << VectorToCommaString(body_update);
-  msg << VectorToCommaString(cam_update.segment(0, g_cam_state_size));
-  msg << VectorToCommaString(cov_diag);
-  msg << "," << std::to_string(feature_tracks.size());
-  msg << "," << t_execution.count();
-  m_msckf_logger.RateLimitedLog(msg.str(), time);
+
+  DataRecord & record = m_msckf_logger.NewRecord();
+  record.Append(time);
+  record.Append(cam_state_vec.segment<3>(0));
+  record.Append(RotVecToQuat(cam_state_vec.segment<3>(3)));
+  record.Append(body_update);
+  record.Append(cam_update.segment(0, g_cam_state_size));
+  record.Append(
+    ekf->GetCov().block(
+      cam_state_start, cam_state_start, g_cam_state_size, g_cam_state_size).diagonal());
+  record.Append(track_count);
+  record.Append(rejected_tracks);
+  record.Append(t_execution.count());
+  m_msckf_logger.LogRecord();
 }
@@ -18,6 +18,7 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,6 +35,15 @@
 class MsckfUpdater : public Updater
 {
 public:
+  ///
+  /// @brief Triangulation method enumerations
+  ///
+  enum class TriangulationMethod
+  {
+    LINEAR,
+    LOST
+  };
+
   ///
   /// @brief MSCKF EKF Updater constructor
   /// @param cam_id Camera sensor ID
@@ -60,19 +70,89 @@ public:
   ///
   Eigen::Vector3d TriangulateFeature(
     std::shared_ptr<EKF> ekf,
-    std::vector<FeaturePoint> & feature_track);
+    const std::vector<FeaturePoint> & feature_track);
+
+  ///
+  /// @brief Triangulate feature using Linear Optimal Sine Triangulation (LOST)
+  /// @param ekf EKF pointer
+  /// @param feature_track Single feature track
+  /// @return Estimate of feature position in global frame given observations
+  ///
+  Eigen::Vector3d TriangulateFeatureLOST(
+    std::shared_ptr<EKF> ekf,
+    const std::vector<FeaturePoint> & feature_track);
+
+  ///
+  /// @brief Pack feature tracks into a structure-of-arrays batch
+  /// @param ekf EKF pointer
+  /// @param feature_tracks Feature tracks to pack
+  /// @return Feature track batch indexed against the camera augmented states
+  ///
+  FeatureTrackBatch CreateTrackBatch(
+    std::shared_ptr<EKF> ekf,
+    const FeatureTracks & feature_tracks);
+
+  ///
+  /// @brief Pack a subset of feature tracks into a structure-of-arrays batch
+  /// @param ekf EKF pointer
+  /// @param feature_tracks Feature tracks to pack from
+  /// @param track_indices Indices of the feature tracks to pack
+  /// @return Feature track batch with one track per index
+  ///
+  FeatureTrackBatch CreateTrackBatch(
+    std::shared_ptr<EKF> ekf,
+    const FeatureTracks & feature_tracks,
+    const std::vector<unsigned int> & track_indices);
+
+  ///
+  /// @brief Triangulate all feature tracks of a batch at once
+  /// @param ekf EKF pointer
+  /// @param track_batch Structure-of-arrays feature track batch
+  /// @return Estimates of feature positions in global frame, one per track
+  ///
+  std::vector<Eigen::Vector3d> TriangulateFeatures(
+    std::shared_ptr<EKF> ekf,
+    const FeatureTrackBatch & track_batch);
+
+  ///
+  /// @brief Rank feature tracks by information and select a subset within the update budget
+  /// @param ekf EKF pointer
+  /// @param feature_tracks Feature tracks to select from
+  /// @param positions_f_in_g Triangulated feature positions
+  /// @return Indices of selected feature tracks, most informative first
+  ///
+  std::vector<unsigned int> SelectFeatureTracks(
+    std::shared_ptr<EKF> ekf,
+    const FeatureTracks & feature_tracks,
+    const std::vector<Eigen::Vector3d> & positions_f_in_g);
+
+  ///
+  /// @brief Rank a subset of feature tracks and select those within the update budget
+  /// @param ekf EKF pointer
+  /// @param feature_tracks Feature tracks to select from
+  /// @param candidate_indices Indices of the candidate feature tracks
+  /// @param positions_f_in_g Triangulated feature positions, indexed as the feature tracks
+  /// @return Indices of selected feature tracks, most informative first
+  ///
+  std::vector<unsigned int> SelectFeatureTracks(
+    std::shared_ptr<EKF> ekf,
+    const FeatureTracks & feature_tracks,
+    const std::vector<unsigned int> & candidate_indices,
+    const std::vector<Eigen::Vector3d> & positions_f_in_g);
 
   ///
   /// @brief EKF updater function
   /// @param time Time of update
   /// @param feature_tracks Feature tracks to be used for state update
   /// @param px_error Standard deviation of pixel error
+  /// @param predict Predict the EKF to the update time before updating
   ///
   void UpdateEKF(
     std::shared_ptr<EKF> ekf,
     double time,
-    FeatureTracks feature_tracks,
-    double px_error);
+    const FeatureTracks & feature_tracks,
+    double px_error,
+    bool predict = true);
 
   ///
   /// @brief Computes the derivative of raw distorted to normalized coordinate.
@@ -92,7 +172,69 @@ public:
   ///
   void projection_jacobian(const Eigen::Vector3d & position, Eigen::MatrixXd & jacobian);
 
+  ///
+  /// @brief Setter for batch triangulation flag
+  /// @param batch_triangulation Use batch triangulation instead of per-track triangulation
+  ///
+  void SetBatchTriangulation(bool batch_triangulation);
+
+  ///
+  /// @brief Setter for triangulation method
+  /// @param triangulation_method Triangulation method
+  ///
+  void SetTriangulationMethod(TriangulationMethod triangulation_method);
+
+  ///
+  /// @brief Setter for per-update compute budget
+  /// @param max_update_rows Maximum measurement rows per update. Zero disables the limit
+  /// @param max_update_time Target update duration in seconds. Zero disables the limit
+  ///
+  void SetUpdateBudget(unsigned int max_update_rows, double max_update_time);
+
 private:
+  ///
+  /// @brief Camera that made an observation
+  /// @param feature_point Feature observation
+  /// @return Observing camera ID, which is this updater's camera unless associated from another
+  ///
+  unsigned int ObservingCamera(const FeaturePoint & feature_point) const;
+
+  ///
+  /// @brief Check if a feature track holds observations from other cameras
+  /// @param feature_track Single feature track
+  /// @return True if any observation was made by another camera
+  ///
+  bool IsMultiCameraTrack(const std::vector<FeaturePoint> & feature_track) const;
+
+  ///
+  /// @brief Check if every observation of a track still has its augmented state
+  /// @param ekf EKF pointer
+  /// @param feature_track Single feature track
+  /// @return False if any observed clone was marginalized
+  ///
+  bool HasAllClones(
+    std::shared_ptr<EKF> ekf,
+    const std::vector<FeaturePoint> & feature_track) const;
+
+  ///
+  /// @brief Write the MSCKF update record if a log is due
+  /// @param ekf EKF pointer
+  /// @param time Time of update
+  /// @param body_update Body state update, zero when no update was applied
+  /// @param cam_update Camera states update, zero when no update was applied
+  /// @param track_count Number of feature tracks given to the update
+  /// @param rejected_tracks Number of tracks rejected by the chi-squared test
+  /// @param t_execution Update execution time
+  ///
+  void LogUpdate(
+    std::shared_ptr<EKF> ekf,
+    double time,
+    const Eigen::VectorXd & body_update,
+    const Eigen::VectorXd & cam_update,
+    unsigned int track_count,
+    unsigned int rejected_tracks,
+    std::chrono::microseconds t_execution);
+
   Eigen::Vector3d m_body_pos {0.0, 0.0, 0.0};
   Eigen::Vector3d m_body_vel {0.0, 0.0, 0.0};
   Eigen::Vector3d m_body_acc {0.0, 0.0, 0.0};
@@ -108,6 +250,11 @@ private:
   DataLogger m_triangulation_logger;
   Intrinsics m_intrinsics;
   double m_min_feat_dist{1.0};
+  bool m_batch_triangulation{true};
+  TriangulationMethod m_triangulation_method{TriangulationMethod::LINEAR};
+  unsigned int m_max_update_rows{0U};
+  double m_max_update_time{0.0};
+  double m_row_update_time{0.0};
 };
 
 #endif  // EKF__UPDATE__MSCKF_UPDATER_HPP_
@@ -53,3 +53,81 @@ TEST(test_imu_updater, constructor) {
 
   fiducial_updater.UpdateEKF(ekf, 0.0, board_track, 1e-2, 1e-2);
 }
+
+TEST(test_fiducial_updater, long_track) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.3, 0.1, 0.0};
+  ekf->Initialize(0.0, body_state);
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Identity(6, 6) * 1e-3);
+
+  FiducialUpdater fiducial_updater(
+    1, Eigen::Vector3d{0.1, 0.2, 3.0}, Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0}, "", false, 0.0,
+    logger);
+
+  BoardTrack board_track;
+  for (int frame_id = 0; frame_id < 20; ++frame_id) {
+    ekf->ProcessModel(0.05 * (frame_id + 1));
+    ekf->AugmentState(1, frame_id);
+    BoardDetection board_detection;
+    board_detection.frame_id = frame_id;
+    board_detection.t_vec_f_in_c = cv::Vec3d{0.1, 0.2 - 0.005 * frame_id, 3.0};
+    board_detection.r_vec_f_to_c = cv::Vec3d{0.0, -0.02, 0.005 * frame_id};
+    board_track.push_back(board_detection);
+  }
+
+  unsigned int cam_state_start = ekf->GetCamStateStartIndex(1);
+  double cam_variance = ekf->GetCov()(cam_state_start, cam_state_start);
+  fiducial_updater.UpdateEKF(ekf, 1.0, board_track, 1e-1, 1e-1);
+
+  Eigen::MatrixXd & cov = ekf->GetCov();
+  EXPECT_TRUE(cov.allFinite());
+  EXPECT_LT((cov - cov.transpose()).norm(), 1e-9);
+  EXPECT_LT(cov(cam_state_start, cam_state_start), cam_variance);
+}
+
+TEST(test_fiducial_updater, multi_board) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  std::vector<std::shared_ptr<EKF>> ekfs;
+  for (unsigned int i = 0; i < 2; ++i) {
+    auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+    ekf->Initialize(0.0, BodyState());
+    ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Identity(6, 6) * 1e-3);
+    ekfs.push_back(ekf);
+  }
+
+  FiducialUpdater fiducial_updater(
+    1, Eigen::Vector3d{0.0, 0.0, 3.0}, Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0}, "", false, 0.0,
+    logger);
+  fiducial_updater.SetBoardPose(1, Eigen::Vector3d{1.0, 0.0, 3.0}, Eigen::Quaterniond{1, 0, 0, 0});
+
+  std::vector<BoardTrack> board_tracks(3);
+  for (int frame_id = 0; frame_id < 5; ++frame_id) {
+    for (auto & ekf : ekfs) {
+      ekf->ProcessModel(0.05 * (frame_id + 1));
+      ekf->AugmentState(1, frame_id);
+    }
+    for (unsigned int board_id = 0; board_id < board_tracks.size(); ++board_id) {
+      BoardDetection board_detection;
+      board_detection.frame_id = frame_id;
+      board_detection.board_id = board_id;
+      board_detection.t_vec_f_in_c = cv::Vec3d{1.0 * board_id, 0.0, 3.0};
+      board_detection.r_vec_f_to_c = cv::Vec3d{0.0, 0.0, 0.0};
+      board_tracks[board_id].push_back(board_detection);
+    }
+  }
+
+  // Board 2 has no pose set and is skipped
+  unsigned int cam_state_start = ekfs[0]->GetCamStateStartIndex(1);
+  fiducial_updater.UpdateEKF(ekfs[0], 1.0, board_tracks[0], 1e-1, 1e-1);
+  fiducial_updater.UpdateEKF(ekfs[1], 1.0, board_tracks, 1e-1, 1e-1);
+
+  Eigen::MatrixXd & cov_single = ekfs[0]->GetCov();
+  Eigen::MatrixXd & cov_stacked = ekfs[1]->GetCov();
+  EXPECT_TRUE(cov_stacked.allFinite());
+  EXPECT_LT((cov_stacked - cov_stacked.transpose()).norm(), 1e-9);
+  double trace_single = cov_single.block(cam_state_start, cam_state_start, 6, 6).trace();
+  double trace_stacked = cov_stacked.block(cam_state_start, cam_state_start, 6, 6).trace();
+  EXPECT_LT(trace_stacked, trace_single);
+}
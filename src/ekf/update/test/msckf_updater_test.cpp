@@ -16,12 +16,82 @@
 #include <eigen3/Eigen/Eigen>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "ekf/ekf.hpp"
 #include "ekf/types.hpp"
 #include "ekf/update/msckf_updater.hpp"
 #include "sensors/types.hpp"
+#include "utility/custom_assertions.hpp"
+#include "utility/sim/sim_rng.hpp"
+
+namespace
+{
+
+/// EKF with camera 1 registered and one clone every 0.1 s
+std::shared_ptr<EKF> CloneEKF(
+  std::shared_ptr<DebugLogger> logger, const BodyState & body_state, unsigned int clone_count,
+  const Eigen::MatrixXd & cam_cov = Eigen::MatrixXd::Zero(6, 6))
+{
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, body_state);
+  ekf->RegisterCamera(1, CamState(), cam_cov);
+  for (unsigned int i = 0; i < clone_count; ++i) {
+    ekf->ProcessModel(0.1 * (i + 1));
+    ekf->AugmentState(1, i);
+  }
+  return ekf;
+}
+
+/// Project a feature into an augmented state with the triangulation camera model
+FeaturePoint Observe(
+  const AugmentedState & aug_state, const Eigen::Vector3d & pos_f_in_g,
+  const Intrinsics & intrinsics)
+{
+  Eigen::Quaterniond ang_c_to_g = aug_state.ang_b_to_g * aug_state.ang_c_to_b;
+  Eigen::Vector3d pos_c_in_g = aug_state.ang_b_to_g * aug_state.pos_c_in_b + aug_state.pos_b_in_g;
+  Eigen::Vector3d pos_f_in_c = ang_c_to_g.inverse() * (pos_f_in_g - pos_c_in_g);
+  FeaturePoint feature_point;
+  feature_point.frame_id = aug_state.frame_id;
+  feature_point.key_point.pt.x = pos_f_in_c(0) / pos_f_in_c(2) *
+    (intrinsics.f_x / intrinsics.pixel_size) + intrinsics.width / 2.0;
+  feature_point.key_point.pt.y = pos_f_in_c(1) / pos_f_in_c(2) *
+    (intrinsics.f_y / intrinsics.pixel_size) + intrinsics.height / 2.0;
+  return feature_point;
+}
+
+/// Project a feature into every augmented state
+std::vector<FeaturePoint> ObserveTrack(
+  const std::vector<AugmentedState> & aug_states, const Eigen::Vector3d & pos_f_in_g,
+  const Intrinsics & intrinsics)
+{
+  std::vector<FeaturePoint> feature_track;
+  for (auto & aug_state : aug_states) {
+    feature_track.push_back(Observe(aug_state, pos_f_in_g, intrinsics));
+  }
+  return feature_track;
+}
+
+/// Intrinsics where the centered and principal point camera models agree
+Intrinsics CenteredIntrinsics(double focal_length)
+{
+  Intrinsics intrinsics;
+  intrinsics.f_x = focal_length;
+  intrinsics.f_y = focal_length;
+  intrinsics.c_x = 320.0;
+  intrinsics.c_y = 240.0;
+  intrinsics.pixel_size = 1.0;
+  return intrinsics;
+}
+
+}  // namespace
 
 TEST(test_msckf_updater, projection_jacobian) {
   auto logger = std::make_shared<DebugLogger>(LogLevel::DEBUG, "");
@@ -116,3 +186,401 @@ TEST(test_msckf_updater, update) {
 
   msckf_updater.UpdateEKF(ekf, time, feature_tracks, 1e-3);
 }
+
+TEST(test_msckf_updater, batch_triangulation) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  Intrinsics intrinsics;
+  SimRNG rng;
+  rng.SetSeed(0.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.5, 1.0, 0.0};
+  body_state.m_angular_velocity = Eigen::Vector3d{0.0, 0.0, 0.1};
+
+  for (unsigned int track_count : {50U, 100U, 250U, 500U}) {
+    auto ekf = CloneEKF(debug_logger, body_state, 5U);
+    std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+
+    // Project random features into every clone
+    FeatureTracks feature_tracks;
+    std::vector<Eigen::Vector3d> features;
+    for (unsigned int t = 0; t < track_count; ++t) {
+      Eigen::Vector3d pos_f_in_g {
+        rng.UniRand(-2.0, 2.0), rng.UniRand(-2.0, 2.0), rng.UniRand(5.0, 10.0)};
+      feature_tracks.push_back(ObserveTrack(aug_states, pos_f_in_g, intrinsics));
+      features.push_back(pos_f_in_g);
+    }
+
+    auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+
+    std::vector<Eigen::Vector3d> single_positions;
+    for (auto & feature_track : feature_tracks) {
+      single_positions.push_back(msckf_updater.TriangulateFeature(ekf, feature_track));
+    }
+    FeatureTrackBatch track_batch = msckf_updater.CreateTrackBatch(ekf, feature_tracks);
+    std::vector<Eigen::Vector3d> batch_positions =
+      msckf_updater.TriangulateFeatures(ekf, track_batch);
+
+    ASSERT_EQ(batch_positions.size(), track_count);
+    for (unsigned int t = 0; t < track_count; ++t) {
+      EXPECT_TRUE(EXPECT_EIGEN_NEAR(batch_positions[t], single_positions[t], 1e-6));
+      EXPECT_TRUE(EXPECT_EIGEN_NEAR(batch_positions[t], features[t], 1e-2));
+    }
+  }
+}
+
+/// Timing of batch against per-track triangulation, run with --gtest_also_run_disabled_tests
+TEST(test_msckf_updater, DISABLED_triangulation_timing) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  unsigned int repetitions{100};
+  Intrinsics intrinsics;
+  SimRNG rng;
+  rng.SetSeed(0.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.5, 1.0, 0.0};
+  body_state.m_angular_velocity = Eigen::Vector3d{0.0, 0.0, 0.1};
+  auto ekf = CloneEKF(debug_logger, body_state, 5U);
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+
+  auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+
+  for (unsigned int track_count : {50U, 100U, 250U, 500U}) {
+    FeatureTracks feature_tracks;
+    for (unsigned int t = 0; t < track_count; ++t) {
+      Eigen::Vector3d pos_f_in_g {
+        rng.UniRand(-2.0, 2.0), rng.UniRand(-2.0, 2.0), rng.UniRand(5.0, 10.0)};
+      feature_tracks.push_back(ObserveTrack(aug_states, pos_f_in_g, intrinsics));
+    }
+
+    // Accumulate the results so the triangulations cannot be optimized away
+    double single_sum{0.0};
+    auto t_start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; ++r) {
+      for (auto & feature_track : feature_tracks) {
+        single_sum += msckf_updater.TriangulateFeature(ekf, feature_track).sum();
+      }
+    }
+    auto t_single = std::chrono::steady_clock::now();
+
+    double batch_sum{0.0};
+    for (unsigned int r = 0; r < repetitions; ++r) {
+      FeatureTrackBatch track_batch = msckf_updater.CreateTrackBatch(ekf, feature_tracks);
+      for (auto & position : msckf_updater.TriangulateFeatures(ekf, track_batch)) {
+        batch_sum += position.sum();
+      }
+    }
+    auto t_batch = std::chrono::steady_clock::now();
+
+    EXPECT_NEAR(single_sum, batch_sum, 1e-6 * std::abs(single_sum));
+
+    double single_us = std::chrono::duration<double, std::micro>(t_single - t_start).count();
+    double batch_us = std::chrono::duration<double, std::micro>(t_batch - t_single).count();
+    std::cout << "tracks: " << track_count <<
+      " per-track: " << single_us / repetitions << " us" <<
+      " batch: " << batch_us / repetitions << " us" <<
+      " speedup: " << single_us / batch_us << std::endl;
+  }
+}
+
+TEST(test_msckf_updater, lost_triangulation) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  unsigned int track_count{250};
+  Intrinsics intrinsics;
+  SimRNG rng;
+  rng.SetSeed(0.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.5, 1.0, 0.0};
+  body_state.m_angular_velocity = Eigen::Vector3d{0.0, 0.0, 0.1};
+  auto ekf = CloneEKF(debug_logger, body_state, 5U);
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+
+  auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+
+  for (double px_error : {0.0, 1.0}) {
+    // Project random features into every clone with pixel noise
+    FeatureTracks feature_tracks;
+    std::vector<Eigen::Vector3d> features;
+    for (unsigned int t = 0; t < track_count; ++t) {
+      Eigen::Vector3d pos_f_in_g {
+        rng.UniRand(-2.0, 2.0), rng.UniRand(-2.0, 2.0), rng.UniRand(5.0, 10.0)};
+      std::vector<FeaturePoint> feature_track = ObserveTrack(aug_states, pos_f_in_g, intrinsics);
+      if (px_error > 0.0) {
+        for (auto & feature_point : feature_track) {
+          feature_point.key_point.pt.x += rng.NormRand(0.0, px_error);
+          feature_point.key_point.pt.y += rng.NormRand(0.0, px_error);
+        }
+      }
+      feature_tracks.push_back(feature_track);
+      features.push_back(pos_f_in_g);
+    }
+
+    double linear_error_squared{0.0};
+    double lost_error_squared{0.0};
+    for (unsigned int t = 0; t < track_count; ++t) {
+      Eigen::Vector3d linear_position = msckf_updater.TriangulateFeature(ekf, feature_tracks[t]);
+      Eigen::Vector3d lost_position = msckf_updater.TriangulateFeatureLOST(ekf, feature_tracks[t]);
+      linear_error_squared += (linear_position - features[t]).squaredNorm();
+      lost_error_squared += (lost_position - features[t]).squaredNorm();
+      if (px_error == 0.0) {
+        EXPECT_TRUE(EXPECT_EIGEN_NEAR(lost_position, features[t], 1e-3));
+      }
+    }
+    double linear_rms = std::sqrt(linear_error_squared / track_count);
+    double lost_rms = std::sqrt(lost_error_squared / track_count);
+    EXPECT_LE(lost_rms, linear_rms * 1.5 + 1e-6);
+  }
+}
+
+/// Timing of LOST against linear triangulation, run with --gtest_also_run_disabled_tests
+TEST(test_msckf_updater, DISABLED_lost_triangulation_timing) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  unsigned int track_count{250};
+  unsigned int repetitions{100};
+  Intrinsics intrinsics;
+  SimRNG rng;
+  rng.SetSeed(0.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.5, 1.0, 0.0};
+  body_state.m_angular_velocity = Eigen::Vector3d{0.0, 0.0, 0.1};
+
+  auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+
+  for (unsigned int clone_count : {3U, 5U, 10U, 20U}) {
+    auto ekf = CloneEKF(debug_logger, body_state, clone_count);
+    std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+
+    FeatureTracks feature_tracks;
+    for (unsigned int t = 0; t < track_count; ++t) {
+      Eigen::Vector3d pos_f_in_g {
+        rng.UniRand(-2.0, 2.0), rng.UniRand(-2.0, 2.0), rng.UniRand(5.0, 10.0)};
+      feature_tracks.push_back(ObserveTrack(aug_states, pos_f_in_g, intrinsics));
+    }
+
+    // Accumulate the results so the triangulations cannot be optimized away
+    double linear_sum{0.0};
+    auto t_start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; ++r) {
+      for (auto & feature_track : feature_tracks) {
+        linear_sum += msckf_updater.TriangulateFeature(ekf, feature_track).sum();
+      }
+    }
+    auto t_linear = std::chrono::steady_clock::now();
+
+    double lost_sum{0.0};
+    for (unsigned int r = 0; r < repetitions; ++r) {
+      for (auto & feature_track : feature_tracks) {
+        lost_sum += msckf_updater.TriangulateFeatureLOST(ekf, feature_track).sum();
+      }
+    }
+    auto t_lost = std::chrono::steady_clock::now();
+
+    EXPECT_NEAR(linear_sum, lost_sum, 1e-3 * std::abs(linear_sum));
+
+    double linear_us = std::chrono::duration<double, std::micro>(t_linear - t_start).count();
+    double lost_us = std::chrono::duration<double, std::micro>(t_lost - t_linear).count();
+    std::cout << "track length: " << clone_count <<
+      " linear: " << linear_us / repetitions << " us" <<
+      " LOST: " << lost_us / repetitions << " us" <<
+      " ratio: " << lost_us / linear_us << std::endl;
+  }
+}
+
+TEST(test_msckf_updater, update_budget) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  unsigned int clone_count{5};
+  Intrinsics intrinsics;
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{1.0, 0.0, 0.0};
+  auto ekf = CloneEKF(debug_logger, body_state, clone_count);
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+
+  // Tracks of increasing length observe the same feature
+  Eigen::Vector3d pos_f_in_g {0.5, 0.5, 5.0};
+  FeatureTracks feature_tracks;
+  std::vector<Eigen::Vector3d> positions_f_in_g;
+  for (unsigned int track_size = 2; track_size <= clone_count; ++track_size) {
+    std::vector<FeaturePoint> feature_track;
+    for (unsigned int i = 0; i < track_size; ++i) {
+      FeaturePoint feature_point;
+      feature_point.frame_id = aug_states[i].frame_id;
+      feature_track.push_back(feature_point);
+    }
+    feature_tracks.push_back(feature_track);
+    positions_f_in_g.push_back(pos_f_in_g);
+  }
+
+  auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+
+  std::vector<unsigned int> all_indices =
+    msckf_updater.SelectFeatureTracks(ekf, feature_tracks, positions_f_in_g);
+  EXPECT_EQ(all_indices.size(), feature_tracks.size());
+
+  // Longest track has the most parallax and observations
+  msckf_updater.SetUpdateBudget(10U, 0.0);
+  std::vector<unsigned int> budget_indices =
+    msckf_updater.SelectFeatureTracks(ekf, feature_tracks, positions_f_in_g);
+  ASSERT_EQ(budget_indices.size(), 2U);
+  EXPECT_EQ(budget_indices[0], 3U);
+  EXPECT_EQ(budget_indices[1], 1U);
+
+  // Tracks closer than the minimum feature distance are never selected
+  positions_f_in_g[3] = Eigen::Vector3d{0.0, 0.0, 0.5};
+  budget_indices = msckf_updater.SelectFeatureTracks(ekf, feature_tracks, positions_f_in_g);
+  ASSERT_EQ(budget_indices.size(), 3U);
+  EXPECT_EQ(budget_indices[0], 2U);
+  EXPECT_EQ(budget_indices[1], 1U);
+  EXPECT_EQ(budget_indices[2], 0U);
+}
+
+TEST(test_msckf_updater, chi_squared_gating) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  Intrinsics intrinsics = CenteredIntrinsics(100.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{1.0, 0.0, 0.0};
+
+  // Corrupt the second track across the epipolar lines of the x translation
+  double state_change[2] {0.0, 0.0};
+  for (bool chi_squared_gating : {true, false}) {
+    auto ekf = CloneEKF(debug_logger, body_state, 5U);
+    std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+    unsigned int state_size = ekf->GetState().GetStateSize();
+    ekf->GetCov() = Eigen::MatrixXd::Identity(state_size, state_size) * 1e-12;
+
+    FeatureTracks feature_tracks;
+    for (auto pos_f_in_g : {Eigen::Vector3d{0.5, 0.5, 5.0}, Eigen::Vector3d{-0.5, 0.5, 6.0}}) {
+      feature_tracks.push_back(ObserveTrack(aug_states, pos_f_in_g, intrinsics));
+    }
+    feature_tracks[1].back().key_point.pt.y += 2.0;
+
+    auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+    msckf_updater.SetChiSquaredGating(chi_squared_gating);
+
+    Eigen::VectorXd state_before = ekf->GetState().ToVector();
+    msckf_updater.UpdateEKF(ekf, 0.5, feature_tracks, 1e-3);
+    state_change[chi_squared_gating] = (ekf->GetState().ToVector() - state_before).norm();
+  }
+
+  // Only the consistent track remains, which has no residual
+  EXPECT_GT(state_change[false], 1e-7);
+  EXPECT_LT(state_change[true], state_change[false] * 1e-3);
+}
+
+TEST(test_msckf_updater, gated_frame_logged) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  Intrinsics intrinsics = CenteredIntrinsics(100.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{1.0, 0.0, 0.0};
+  auto ekf = CloneEKF(debug_logger, body_state, 5U);
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+  unsigned int state_size = ekf->GetState().GetStateSize();
+  ekf->GetCov() = Eigen::MatrixXd::Identity(state_size, state_size) * 1e-12;
+
+  // Every track is corrupted and rejected
+  FeatureTracks feature_tracks;
+  for (auto pos_f_in_g : {Eigen::Vector3d{0.5, 0.5, 5.0}, Eigen::Vector3d{-0.5, 0.5, 6.0}}) {
+    feature_tracks.push_back(ObserveTrack(aug_states, pos_f_in_g, intrinsics));
+    feature_tracks.back().back().key_point.pt.y += 2.0;
+  }
+
+  {
+    auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", true, 0.0, 1.0, debug_logger);
+    msckf_updater.SetChiSquaredGating(true);
+    msckf_updater.UpdateEKF(ekf, 0.5, feature_tracks, 1e-3);
+  }
+
+  std::ifstream log_file("msckf_1.csv");
+  std::string header, row, header_value, row_value;
+  ASSERT_TRUE(std::getline(log_file, header));
+  ASSERT_TRUE(std::getline(log_file, row));
+  std::stringstream header_stream(header);
+  std::stringstream row_stream(row);
+  while (std::getline(header_stream, header_value, ',') &&
+    std::getline(row_stream, row_value, ','))
+  {
+    if (header_value == "RejectedTracks") {
+      break;
+    }
+  }
+  EXPECT_EQ(header_value, "RejectedTracks");
+  EXPECT_EQ(row_value, "2");
+}
+
+TEST(test_msckf_updater, marginalized_clone) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  unsigned int cam_id{1};
+  Intrinsics intrinsics = CenteredIntrinsics(100.0);
+
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{1.0, 0.0, 0.0};
+  auto ekf = CloneEKF(debug_logger, body_state, 5U);
+  std::vector<AugmentedState> aug_states = ekf->GetCamState(cam_id).augmented_states;
+  FeatureTracks feature_tracks {
+    ObserveTrack(aug_states, Eigen::Vector3d{0.5, 0.5, 5.0}, intrinsics)};
+
+  // Next clone marginalizes the first frame of the track
+  ekf->SetMaxTrackLength(5U);
+  ekf->AugmentState(cam_id, 5);
+  ASSERT_FALSE(ekf->HasAugmentedState(cam_id, feature_tracks[0][0].frame_id));
+
+  auto msckf_updater = MsckfUpdater(cam_id, intrinsics, "", false, 0.0, 1.0, debug_logger);
+  Eigen::VectorXd state_before = ekf->GetState().ToVector();
+  Eigen::MatrixXd cov_before = ekf->GetCov();
+  msckf_updater.UpdateEKF(ekf, 0.5, feature_tracks, 1e-3);
+  EXPECT_TRUE(EXPECT_EIGEN_NEAR(ekf->GetState().ToVector(), state_before, 1e-12));
+  EXPECT_EQ((ekf->GetCov() - cov_before).norm(), 0.0);
+}
+
+TEST(test_msckf_updater, multi_camera_track) {
+  auto debug_logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(debug_logger, 10.0, false, "");
+  BodyState body_state;
+  body_state.m_velocity = Eigen::Vector3d{0.5, 0.0, 0.0};
+  ekf->Initialize(0.0, body_state);
+
+  Intrinsics intrinsics = CenteredIntrinsics(500.0);
+
+  CamState cam_state_2;
+  cam_state_2.pos_c_in_b = Eigen::Vector3d{0.0, 0.5, 0.0};
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+  ekf->RegisterCamera(2, cam_state_2, Eigen::MatrixXd::Zero(6, 6));
+  for (int i = 0; i < 3; ++i) {
+    ekf->ProcessModel(0.1 * (i + 1));
+    ekf->AugmentState(1, 2 * i);
+    ekf->AugmentState(2, 2 * i + 1);
+  }
+
+  // Camera 1 track with the camera 2 observations appended
+  Eigen::Vector3d pos_f_in_g {0.3, -0.2, 6.0};
+  std::vector<FeaturePoint> feature_track;
+  for (int cam_id : {1, 2}) {
+    for (auto & aug_state : ekf->GetCamState(cam_id).augmented_states) {
+      FeaturePoint feature_point = Observe(aug_state, pos_f_in_g, intrinsics);
+      feature_point.camera_id = (cam_id == 1) ? -1 : cam_id;
+      feature_track.push_back(feature_point);
+    }
+  }
+  FeatureTracks feature_tracks {feature_track};
+
+  auto msckf_updater = MsckfUpdater(1, intrinsics, "", false, 0.0, 1.0, debug_logger);
+  EXPECT_TRUE(EXPECT_EIGEN_NEAR(
+      msckf_updater.TriangulateFeature(ekf, feature_track), pos_f_in_g, 1e-4));
+
+  // Both cameras' clones take part in the update
+  unsigned int clone_start = ekf->GetAugStateStartIndex(2, 1);
+  double clone_variance = ekf->GetCov()(clone_start, clone_start);
+  msckf_updater.UpdateEKF(ekf, 0.3, feature_tracks, 1e-3);
+  EXPECT_LT(ekf->GetCov()(clone_start, clone_start), clone_variance);
+}
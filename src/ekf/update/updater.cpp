@@ -15,7 +15,39 @@
 
 #include "ekf/update/updater.hpp"
 
+#include <eigen3/Eigen/Eigen>
+
+#include <cmath>
 #include <memory>
 
+#include "utility/math_helper.hpp"
+
 Updater::Updater(unsigned int sensor_id, std::shared_ptr<DebugLogger> logger)
 : m_id(sensor_id), m_logger(logger) {}
+
+void Updater::SetChiSquaredGating(bool chi_squared_gating)
+{
+  m_chi_squared_gating = chi_squared_gating;
+}
+
+bool Updater::ChiSquaredTest(
+  const Eigen::MatrixXd & jacobian,
+  const Eigen::MatrixXd & covariance,
+  const Eigen::VectorXd & residual,
+  double variance)
+{
+  if (!m_chi_squared_gating || (residual.size() == 0) || (variance <= 0.0)) {
+    return true;
+  }
+
+  Eigen::MatrixXd S = jacobian * covariance * jacobian.transpose();
+  S.diagonal().array() += variance;
+  double gamma = residual.dot(S.ldlt().solve(residual));
+
+  // Degenerate innovation covariance cannot be gated
+  if (!std::isfinite(gamma)) {
+    return true;
+  }
+
+  return gamma < ChiSquared95(residual.size());
+}
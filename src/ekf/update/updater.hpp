@@ -16,6 +16,8 @@
 #ifndef EKF__UPDATE__UPDATER_HPP_
 #define EKF__UPDATE__UPDATER_HPP_
 
+#include <eigen3/Eigen/Eigen>
+
 #include <memory>
 
 #include "ekf/ekf.hpp"
@@ -45,9 +47,30 @@ public:
   //   Eigen::MatrixXd residual,
   //   Eigen::MatrixXd jacobian);
 
+  ///
+  /// @brief Setter for chi-squared measurement gating
+  /// @param chi_squared_gating Reject measurements failing the 95% chi-squared test
+  ///
+  void SetChiSquaredGating(bool chi_squared_gating);
+
 protected:
+  ///
+  /// @brief Mahalanobis gate of a measurement against its innovation covariance
+  /// @param jacobian Measurement Jacobian with respect to the covariance block
+  /// @param covariance Restricted state covariance
+  /// @param residual Measurement residual
+  /// @param variance Measurement noise variance
+  /// @return True if the measurement passes the gate
+  ///
+  bool ChiSquaredTest(
+    const Eigen::MatrixXd & jacobian,
+    const Eigen::MatrixXd & covariance,
+    const Eigen::VectorXd & residual,
+    double variance);
+
   unsigned int m_id;                      ///< @brief Associated sensor ID
   std::shared_ptr<DebugLogger> m_logger;  ///< @brief Debug logger
+  bool m_chi_squared_gating {true};       ///< @brief Chi-squared gating flag
 };
 
 #endif  // EKF__UPDATE__UPDATER_HPP_
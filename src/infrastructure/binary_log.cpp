@@ -0,0 +1,167 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "infrastructure/binary_log.hpp"
+
+#include <eigen3/Eigen/Eigen>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+std::vector<std::string> SplitHeader(const std::string & header)
+{
+  std::vector<std::string> columns;
+  if (header.empty()) {
+    return columns;
+  }
+  size_t start {0};
+  size_t end = header.find(',');
+  while (end != std::string::npos) {
+    columns.push_back(header.substr(start, end - start));
+    start = end + 1;
+    end = header.find(',', start);
+  }
+  columns.push_back(header.substr(start));
+  return columns;
+}
+
+void WriteBinaryLogHeader(std::ostream & stream, const std::vector<std::string> & columns)
+{
+  std::string names;
+  for (unsigned int i = 0; i < columns.size(); ++i) {
+    names += (i > 0) ? "," + columns[i] : columns[i];
+  }
+  names.resize((names.size() + 7) / 8 * 8, '\0');
+
+  uint32_t column_count = columns.size();
+  uint64_t names_size = names.size();
+  stream.write(g_binary_log_magic, sizeof(g_binary_log_magic));
+  stream.write(reinterpret_cast<const char *>(&g_binary_log_version), sizeof(uint32_t));
+  stream.write(reinterpret_cast<const char *>(&column_count), sizeof(uint32_t));
+  stream.write(reinterpret_cast<const char *>(&names_size), sizeof(uint64_t));
+  stream.write(names.data(), names.size());
+}
+
+void AppendBinaryLogRow(const std::string & record, unsigned int column_count, std::string & buffer)
+{
+  const char * field = record.c_str();
+  for (unsigned int i = 0; i < column_count; ++i) {
+    double value = std::numeric_limits<double>::quiet_NaN();
+    if (field) {
+      char * field_end {nullptr};
+      double parsed = std::strtod(field, &field_end);
+      if (field_end != field) {
+        value = parsed;
+      }
+      field = std::strchr(field_end, ',');
+      if (field) {
+        ++field;
+      }
+    }
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(double));
+  }
+}
+
+void AppendBinaryLogValues(
+  const std::string & values, unsigned int column_count, std::string & buffer)
+{
+  size_t row_size = sizeof(double) * column_count;
+  size_t copy_size = std::min(values.size() / sizeof(double) * sizeof(double), row_size);
+  buffer.append(values.data(), copy_size);
+
+  double value = std::numeric_limits<double>::quiet_NaN();
+  for (size_t size = copy_size; size < row_size; size += sizeof(double)) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(double));
+  }
+}
+
+void BinaryRecord::Clear()
+{
+  m_buffer.clear();
+}
+
+BinaryRecord & BinaryRecord::Append(double value)
+{
+  m_buffer.append(reinterpret_cast<const char *>(&value), sizeof(double));
+  return *this;
+}
+
+BinaryRecord & BinaryRecord::Append(const Eigen::Quaterniond & quat)
+{
+  Append(quat.w());
+  Append(quat.x());
+  Append(quat.y());
+  Append(quat.z());
+  return *this;
+}
+
+const std::string & BinaryRecord::Bytes() const
+{
+  return m_buffer;
+}
+
+BinaryLogReader::BinaryLogReader(std::string file_path)
+: m_file(file_path, std::ios::binary)
+{
+  char magic[sizeof(g_binary_log_magic)];
+  uint32_t version {0U};
+  uint32_t column_count {0U};
+  uint64_t names_size {0U};
+  m_file.read(magic, sizeof(magic));
+  m_file.read(reinterpret_cast<char *>(&version), sizeof(uint32_t));
+  m_file.read(reinterpret_cast<char *>(&column_count), sizeof(uint32_t));
+  m_file.read(reinterpret_cast<char *>(&names_size), sizeof(uint64_t));
+  if (!m_file ||
+    (std::memcmp(magic, g_binary_log_magic, sizeof(magic)) != 0) ||
+    (version != g_binary_log_version))
+  {
+    return;
+  }
+
+  std::string names(names_size, '\0');
+  m_file.read(&names[0], names_size);
+  names.resize(std::strlen(names.c_str()));
+  m_columns = SplitHeader(names);
+  m_valid = m_file && (m_columns.size() == column_count);
+}
+
+bool BinaryLogReader::IsValid()
+{
+  return m_valid;
+}
+
+std::vector<std::string> BinaryLogReader::GetColumns()
+{
+  return m_columns;
+}
+
+bool BinaryLogReader::ReadRow(std::vector<double> & row)
+{
+  if (!m_valid || m_columns.empty()) {
+    return false;
+  }
+  row.resize(m_columns.size());
+  m_file.read(reinterpret_cast<char *>(row.data()), sizeof(double) * row.size());
+
+  // A partially written trailing row is not returned
+  return static_cast<size_t>(m_file.gcount()) == sizeof(double) * row.size();
+}
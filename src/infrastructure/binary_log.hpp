@@ -0,0 +1,177 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef INFRASTRUCTURE__BINARY_LOG_HPP_
+#define INFRASTRUCTURE__BINARY_LOG_HPP_
+
+#include <eigen3/Eigen/Eigen>
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+///
+/// @brief Binary columnar log layout
+///
+/// Files start with an 8 byte magic string, a uint32 format version, a uint32 column count and a
+/// uint64 byte size of the column name block. The name block holds the comma-separated column
+/// names padded with null bytes to a multiple of 8. Rows follow as one little-endian double per
+/// column, so the row data can be memory-mapped directly.
+///
+static constexpr char g_binary_log_magic[8] {'E', 'K', 'F', 'C', 'A', 'L', 'B', 'L'};
+static constexpr uint32_t g_binary_log_version {1U};
+
+///
+/// @brief Split a comma-separated header into column names
+/// @param header Comma-separated header
+/// @return Column names
+///
+std::vector<std::string> SplitHeader(const std::string & header);
+
+///
+/// @brief Write a binary log file header
+/// @param stream Output stream
+/// @param columns Column names
+///
+void WriteBinaryLogHeader(std::ostream & stream, const std::vector<std::string> & columns);
+
+///
+/// @brief Append a comma-separated record as one binary row
+/// @param record Comma-separated values
+/// @param column_count Number of columns in the row
+/// @param buffer Buffer to append the row bytes to
+///
+/// Missing or malformed values are written as NaN
+///
+void AppendBinaryLogRow(
+  const std::string & record, unsigned int column_count, std::string & buffer);
+
+///
+/// @brief Append packed row values as one binary row
+/// @param values Packed doubles, as built by BinaryRecord
+/// @param column_count Number of columns in the row
+/// @param buffer Buffer to append the row bytes to
+///
+/// Values beyond the column count are dropped and missing values are written as NaN
+///
+void AppendBinaryLogValues(
+  const std::string & values, unsigned int column_count, std::string & buffer);
+
+///
+/// @class BinaryRecord
+/// @brief Binary log row packed into a reusable buffer
+///
+/// Takes the same values as CsvRecord, but stores each one as a double in the binary log row
+/// layout, so rows are written at full precision without being formatted or parsed.
+///
+class BinaryRecord
+{
+public:
+  ///
+  /// @brief Clear the record while keeping the buffer capacity
+  ///
+  void Clear();
+
+  ///
+  /// @brief Append a floating point value
+  /// @param value Value to append
+  /// @return Reference to this record
+  ///
+  BinaryRecord & Append(double value);
+
+  ///
+  /// @brief Append an integer value
+  /// @param value Value to append
+  /// @return Reference to this record
+  ///
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value, BinaryRecord &>::type Append(T value)
+  {
+    return Append(static_cast<double>(value));
+  }
+
+  ///
+  /// @brief Append every coefficient of an Eigen vector or expression without copying it
+  /// @param vec Vector expression to append
+  /// @return Reference to this record
+  ///
+  template<typename Derived>
+  BinaryRecord & Append(const Eigen::DenseBase<Derived> & vec)
+  {
+    for (Eigen::Index i = 0; i < vec.size(); ++i) {
+      Append(static_cast<double>(vec.coeff(i)));
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief Append a quaternion in w, x, y, z order
+  /// @param quat Quaternion to append
+  /// @return Reference to this record
+  ///
+  BinaryRecord & Append(const Eigen::Quaterniond & quat);
+
+  ///
+  /// @brief Record contents getter
+  /// @return Packed row values
+  ///
+  const std::string & Bytes() const;
+
+private:
+  std::string m_buffer;
+};
+
+///
+/// @class BinaryLogReader
+/// @brief Sequential reader for binary columnar log files
+///
+class BinaryLogReader
+{
+public:
+  ///
+  /// @brief BinaryLogReader constructor
+  /// @param file_path Path of the binary log file
+  ///
+  explicit BinaryLogReader(std::string file_path);
+
+  ///
+  /// @brief Check that the file was opened and has a valid header
+  /// @return True if rows can be read
+  ///
+  bool IsValid();
+
+  ///
+  /// @brief Column names getter
+  /// @return Column names
+  ///
+  std::vector<std::string> GetColumns();
+
+  ///
+  /// @brief Read the next complete row
+  /// @param row Output row values
+  /// @return False at the end of the file
+  ///
+  bool ReadRow(std::vector<double> & row);
+
+private:
+  std::ifstream m_file;
+  bool m_valid {false};
+  std::vector<std::string> m_columns;
+};
+
+#endif  // INFRASTRUCTURE__BINARY_LOG_HPP_
@@ -15,8 +15,53 @@
 
 #include "infrastructure/data_logger.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "infrastructure/binary_log.hpp"
+
+void DataRecord::Clear()
+{
+  m_csv_record.Clear();
+  m_binary_record.Clear();
+}
+
+void DataRecord::SetBinary(bool binary)
+{
+  m_binary = binary;
+}
+
+bool DataRecord::IsBinary() const
+{
+  return m_binary;
+}
+
+void DataRecord::SetPrecision(unsigned int precision)
+{
+  m_csv_record.SetPrecision(precision);
+}
+
+unsigned int DataRecord::GetPrecision() const
+{
+  return m_csv_record.GetPrecision();
+}
+
+const std::string & DataRecord::Data() const
+{
+  return m_binary ? m_binary_record.Bytes() : m_csv_record.String();
+}
+
+static DataLogger::LogFormat g_default_log_format {DataLogger::LogFormat::CSV};
+static DataLogger::OverflowPolicy g_default_overflow_policy {DataLogger::OverflowPolicy::BLOCK};
+static unsigned int g_default_queue_size {4096U};
+static double g_default_flush_period {1.0};
 
 DataLogger::DataLogger(std::string output_directory, std::string file_name)
 {
@@ -31,35 +76,265 @@ DataLogger::DataLogger(std::string output_directory, std::string file_name, doub
   m_rate = logging_rate;
 }
 
+DataLogger::DataLogger(DataLogger && other)
+{
+  other.StopWriter();
+  m_initialized = other.m_initialized;
+  m_log_header = other.m_log_header;
+  m_log_file = std::move(other.m_log_file);
+  m_logging_on = other.m_logging_on;
+  m_output_directory = other.m_output_directory;
+  m_file_name = other.m_file_name;
+  m_rate = other.m_rate;
+  m_time_init = other.m_time_init;
+  m_log_count = other.m_log_count;
+  m_overflow_policy = other.m_overflow_policy;
+  m_overflow_policy_set = other.m_overflow_policy_set;
+  m_log_format = other.m_log_format;
+  m_log_format_set = other.m_log_format_set;
+  m_columns = other.m_columns;
+  m_record.SetPrecision(other.m_record.GetPrecision());
+  m_queue_size = other.m_queue_size;
+  m_queue_size_set = other.m_queue_size_set;
+  m_flush_period = other.m_flush_period;
+  m_flush_period_set = other.m_flush_period_set;
+  m_drop_count = other.m_drop_count.load();
+}
+
+DataLogger::~DataLogger()
+{
+  StopWriter();
+}
+
 void DataLogger::Log(std::string message)
 {
-  if (m_logging_on) {
-    if (!m_initialized) {
-      m_log_file.open(m_output_directory + m_file_name);
-      m_log_file << m_log_header << std::endl;
-      m_initialized = true;
+  uint64_t head {0U};
+  if (ReserveSlot(head)) {
+    QueuedRecord & record = m_queue[head % m_queue.size()];
+    record.data = std::move(message);
+    record.binary = false;
+    CommitSlot(head);
+  }
+}
+
+DataRecord & DataLogger::NewRecord()
+{
+  m_record.Clear();
+  m_record.SetBinary(GetLogFormat() == LogFormat::BINARY);
+  return m_record;
+}
+
+void DataLogger::LogRecord()
+{
+  // Copying into the slot reuses its capacity, so steady-state records do not allocate
+  uint64_t head {0U};
+  if (ReserveSlot(head)) {
+    QueuedRecord & record = m_queue[head % m_queue.size()];
+    record.data.assign(m_record.Data());
+    record.binary = m_record.IsBinary();
+    CommitSlot(head);
+  }
+}
+
+bool DataLogger::ReserveSlot(uint64_t & head)
+{
+  if (!m_logging_on) {
+    return false;
+  }
+  if (!m_initialized) {
+    OpenLogFile();
+    m_initialized = true;
+  }
+  if (!m_writer_thread.joinable()) {
+    StartWriter();
+  }
+
+  head = m_queue_head.load(std::memory_order_relaxed);
+  while (head - m_queue_tail.load(std::memory_order_acquire) >= m_queue.size()) {
+    if (m_overflow_policy == OverflowPolicy::DROP) {
+      ++m_drop_count;
+      return false;
     }
-    m_log_file << message << std::endl;
-    ++m_log_count;
+    m_writer_cv.notify_one();
+    std::this_thread::yield();
   }
+  return true;
 }
 
-void DataLogger::RateLimitedLog(std::string message, double time)
+void DataLogger::CommitSlot(uint64_t head)
+{
+  m_queue_head.store(head + 1, std::memory_order_release);
+  ++m_log_count;
+
+  // Wake the writer early once the queue is half full
+  if (QueueCount() == m_queue.size() / 2) {
+    m_writer_cv.notify_one();
+  }
+}
+
+DataLogger::LogFormat DataLogger::GetLogFormat()
+{
+  if (!m_initialized && !m_log_format_set) {
+    m_log_format = g_default_log_format;
+  }
+  return m_log_format;
+}
+
+void DataLogger::OpenLogFile()
+{
+  if (GetLogFormat() == LogFormat::BINARY) {
+    std::string file_name = m_file_name;
+    if ((file_name.size() > 4) && (file_name.compare(file_name.size() - 4, 4, ".csv") == 0)) {
+      file_name.replace(file_name.size() - 4, 4, ".bin");
+    }
+    m_log_file.open(m_output_directory + file_name, std::ios::binary);
+
+    // Without a header the columns are taken from the first record
+    m_columns = SplitHeader(m_log_header);
+    if (!m_columns.empty()) {
+      WriteBinaryLogHeader(m_log_file, m_columns);
+    }
+  } else {
+    m_log_file.open(m_output_directory + m_file_name);
+    m_log_file << m_log_header << "\n";
+  }
+}
+
+uint64_t DataLogger::QueueCount()
+{
+  return m_queue_head.load(std::memory_order_acquire) -
+    m_queue_tail.load(std::memory_order_acquire);
+}
+
+void DataLogger::StartWriter()
 {
-  if (m_logging_on) {
-    if (m_time_init) {
-      double log_count = static_cast<double>(m_log_count);
-      double max_count = m_rate * (time - m_time_init);
-      if ((m_rate == 0.0) || (log_count < max_count)) {
-        Log(message);
+  if (!m_overflow_policy_set) {
+    m_overflow_policy = g_default_overflow_policy;
+  }
+  if (!m_queue_size_set) {
+    m_queue_size = g_default_queue_size;
+  }
+  if (!m_flush_period_set) {
+    m_flush_period = g_default_flush_period;
+  }
+  m_queue.assign(std::max(m_queue_size, 2U), QueuedRecord());
+  m_queue_head = 0U;
+  m_queue_tail = 0U;
+  m_stop_writer = false;
+  m_flush_requested = false;
+  m_writer_thread = std::thread(&DataLogger::WriterLoop, this);
+}
+
+void DataLogger::StopWriter()
+{
+  if (m_writer_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_writer_mutex);
+      m_stop_writer = true;
+    }
+    m_writer_cv.notify_one();
+    m_writer_thread.join();
+  }
+}
+
+void DataLogger::WriteQueue()
+{
+  std::lock_guard<std::mutex> file_lock(m_file_mutex);
+  uint64_t tail = m_queue_tail.load(std::memory_order_relaxed);
+  uint64_t head = m_queue_head.load(std::memory_order_acquire);
+
+  // Records are joined into one buffer so each batch is a single stream write
+  m_write_buffer.clear();
+  for (; tail < head; ++tail) {
+    QueuedRecord & record = m_queue[tail % m_queue.size()];
+    if (m_log_format == LogFormat::BINARY) {
+      if (m_columns.empty()) {
+        unsigned int column_count = record.binary ?
+          record.data.size() / sizeof(double) :
+          std::count(record.data.begin(), record.data.end(), ',') + 1;
+        for (unsigned int i = 0; i < column_count; ++i) {
+          m_columns.push_back("col_" + std::to_string(i));
+        }
+        WriteBinaryLogHeader(m_log_file, m_columns);
+      }
+
+      // Only text passed to Log is parsed, packed records are written as they are
+      if (record.binary) {
+        AppendBinaryLogValues(record.data, m_columns.size(), m_write_buffer);
+      } else {
+        AppendBinaryLogRow(record.data, m_columns.size(), m_write_buffer);
       }
     } else {
-      m_time_init = time;
-      Log(message);
+      m_write_buffer.append(record.data);
+      m_write_buffer.push_back('\n');
+    }
+    record.data.clear();
+  }
+  m_queue_tail.store(tail, std::memory_order_release);
+
+  m_log_file.write(m_write_buffer.data(), m_write_buffer.size());
+  m_log_file.flush();
+}
+
+void DataLogger::WriterLoop()
+{
+  auto flush_period = std::chrono::duration<double>(m_flush_period);
+  bool stop {false};
+  while (!stop) {
+    bool flush {false};
+    {
+      std::unique_lock<std::mutex> lock(m_writer_mutex);
+      m_writer_cv.wait_for(
+        lock, flush_period, [this] {
+          return m_stop_writer || m_flush_requested || (QueueCount() >= m_queue.size() / 2);
+        });
+      stop = m_stop_writer;
+      flush = m_flush_requested;
     }
+    WriteQueue();
+
+    // Records committed before the flush request are covered by this write
+    if (flush) {
+      {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_flush_requested = false;
+      }
+      m_flush_cv.notify_all();
+    }
+  }
+}
+
+void DataLogger::Flush()
+{
+  if (m_writer_thread.joinable()) {
+    std::unique_lock<std::mutex> lock(m_writer_mutex);
+    m_flush_requested = true;
+    m_writer_cv.notify_one();
+    m_flush_cv.wait(lock, [this] {return !m_flush_requested;});
+  }
+}
+
+void DataLogger::RateLimitedLog(std::string message, double time)
+{
+  if (IsLogDue(time)) {
+    Log(std::move(message));
   }
 }
 
+bool DataLogger::IsLogDue(double time)
+{
+  if (!m_logging_on) {
+    return false;
+  }
+  if (!m_time_init) {
+    m_time_init = time;
+    return true;
+  }
+  double log_count = static_cast<double>(m_log_count);
+  double max_count = m_rate * (time - m_time_init);
+  return (m_rate == 0.0) || (log_count < max_count);
+}
+
 void DataLogger::SetLogging(bool value)
 {
   m_logging_on = value;
@@ -87,3 +362,57 @@ void DataLogger::SetLogRate(double rate)
 {
   m_rate = rate;
 }
+
+void DataLogger::SetOverflowPolicy(OverflowPolicy policy)
+{
+  m_overflow_policy = policy;
+  m_overflow_policy_set = true;
+}
+
+void DataLogger::SetLogFormat(LogFormat log_format)
+{
+  m_log_format = log_format;
+  m_log_format_set = true;
+}
+
+void DataLogger::SetDefaultLogFormat(LogFormat log_format)
+{
+  g_default_log_format = log_format;
+}
+
+void DataLogger::SetDefaultOverflowPolicy(OverflowPolicy policy)
+{
+  g_default_overflow_policy = policy;
+}
+
+void DataLogger::SetDefaultQueueSize(unsigned int queue_size)
+{
+  g_default_queue_size = queue_size;
+}
+
+void DataLogger::SetDefaultFlushPeriod(double flush_period)
+{
+  g_default_flush_period = flush_period;
+}
+
+void DataLogger::SetPrecision(unsigned int precision)
+{
+  m_record.SetPrecision(precision);
+}
+
+void DataLogger::SetQueueSize(unsigned int queue_size)
+{
+  m_queue_size = queue_size;
+  m_queue_size_set = true;
+}
+
+void DataLogger::SetFlushPeriod(double flush_period)
+{
+  m_flush_period = flush_period;
+  m_flush_period_set = true;
+}
+
+unsigned int DataLogger::GetDropCount()
+{
+  return m_drop_count;
+}
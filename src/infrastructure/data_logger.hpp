@@ -16,15 +16,112 @@
 #ifndef INFRASTRUCTURE__DATA_LOGGER_HPP_
 #define INFRASTRUCTURE__DATA_LOGGER_HPP_
 
-#include <string>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "infrastructure/binary_log.hpp"
+#include "utility/string_helper.hpp"
+
+///
+/// @class DataRecord
+/// @brief Data log record built in the file format of its logger
+///
+/// Values are formatted as comma-separated text for CSV logs and packed as doubles for binary
+/// logs, so binary rows keep full precision and are never parsed back from text.
+///
+class DataRecord
+{
+public:
+  ///
+  /// @brief Clear the record while keeping the buffer capacity
+  ///
+  void Clear();
+
+  ///
+  /// @brief Record format setter
+  /// @param binary True to pack values as binary log row doubles
+  ///
+  void SetBinary(bool binary);
+
+  ///
+  /// @brief Record format getter
+  /// @return True if values are packed as binary log row doubles
+  ///
+  bool IsBinary() const;
+
+  ///
+  /// @brief Floating point precision setter for CSV records
+  /// @param precision Significant digits of floating point values
+  ///
+  void SetPrecision(unsigned int precision);
+
+  ///
+  /// @brief Floating point precision getter for CSV records
+  /// @return Significant digits of floating point values
+  ///
+  unsigned int GetPrecision() const;
+
+  ///
+  /// @brief Append a value, integer, Eigen vector or quaternion
+  /// @param value Value to append
+  /// @return Reference to this record
+  ///
+  template<typename T>
+  DataRecord & Append(const T & value)
+  {
+    if (m_binary) {
+      m_binary_record.Append(value);
+    } else {
+      m_csv_record.Append(value);
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief Record contents getter
+  /// @return Comma-separated text, or packed doubles for binary records
+  ///
+  const std::string & Data() const;
+
+private:
+  bool m_binary {false};
+  CsvRecord m_csv_record;
+  BinaryRecord m_binary_record;
+};
 
 ///
 /// @brief DataLogger class
 ///
+/// Records are queued in a single-producer ring buffer and written to file in batches by a
+/// background thread, so logging does not block the calling thread on file output.
+///
 class DataLogger
 {
 public:
+  ///
+  /// @brief Behavior when the record queue is full
+  ///
+  enum class OverflowPolicy
+  {
+    BLOCK,  ///< @brief Wait for the writer thread to free space
+    DROP,   ///< @brief Discard the record
+  };
+
+  ///
+  /// @brief Log file format
+  ///
+  enum class LogFormat
+  {
+    CSV,     ///< @brief Comma-separated text
+    BINARY,  ///< @brief Binary columnar doubles. See infrastructure/binary_log.hpp
+  };
+
   DataLogger() {}
 
   ///
@@ -42,12 +139,40 @@ public:
   ///
   DataLogger(std::string output_directory, std::string file_name, double logging_rate);
 
+  ///
+  /// @brief DataLogger move constructor. Writes all records queued by the moved-from logger
+  /// @param other Logger to move from
+  ///
+  DataLogger(DataLogger && other);
+
+  ///
+  /// @brief DataLogger destructor. Writes all queued records before closing the file
+  ///
+  ~DataLogger();
+
   ///
   /// @brief Log message
   /// @param message Message contents of log
   ///
   void Log(std::string message);
 
+  ///
+  /// @brief Start a new record in the logger's reusable record buffer
+  /// @return Cleared record to append values to before calling LogRecord
+  ///
+  DataRecord & NewRecord();
+
+  ///
+  /// @brief Log the contents of the record buffer
+  ///
+  void LogRecord();
+
+  ///
+  /// @brief Floating point precision setter for CSV records built with NewRecord
+  /// @param precision Significant digits of floating point values
+  ///
+  void SetPrecision(unsigned int precision);
+
   ///
   /// @brief Log rate-limited messages
   /// @param message Message contents of log
@@ -55,6 +180,15 @@ public:
   ///
   void RateLimitedLog(std::string message, double time);
 
+  ///
+  /// @brief Check if a rate-limited record would be written, before building it
+  /// @param time Message log time for rate-limited logging
+  /// @return True if logging is on and the rate limit allows a record at this time
+  ///
+  /// Callers that get true are expected to Log the record
+  ///
+  bool IsLogDue(double time);
+
   ///
   /// @brief Function to set the output file header
   /// @param header Header string for output file
@@ -85,7 +219,85 @@ public:
   ///
   void SetLogRate(double rate);
 
+  ///
+  /// @brief Queue overflow policy setter
+  /// @param policy Behavior when the record queue is full
+  ///
+  void SetOverflowPolicy(OverflowPolicy policy);
+
+  ///
+  /// @brief Record queue size setter. Only applies before the first record is logged
+  /// @param queue_size Maximum number of queued records
+  ///
+  void SetQueueSize(unsigned int queue_size);
+
+  ///
+  /// @brief File flush period setter. Only applies before the first record is logged
+  /// @param flush_period Maximum time between file flushes [s]
+  ///
+  void SetFlushPeriod(double flush_period);
+
+  ///
+  /// @brief Log file format setter. Only applies before the first record is logged
+  /// @param log_format Log file format
+  ///
+  void SetLogFormat(LogFormat log_format);
+
+  ///
+  /// @brief Log file format setter for loggers without an explicit format
+  /// @param log_format Log file format
+  ///
+  static void SetDefaultLogFormat(LogFormat log_format);
+
+  ///
+  /// @brief Queue overflow policy setter for loggers without an explicit policy
+  /// @param policy Behavior when the record queue is full
+  ///
+  static void SetDefaultOverflowPolicy(OverflowPolicy policy);
+
+  ///
+  /// @brief Record queue size setter for loggers without an explicit queue size
+  /// @param queue_size Maximum number of queued records
+  ///
+  static void SetDefaultQueueSize(unsigned int queue_size);
+
+  ///
+  /// @brief File flush period setter for loggers without an explicit flush period
+  /// @param flush_period Maximum time between file flushes [s]
+  ///
+  static void SetDefaultFlushPeriod(double flush_period);
+
+  ///
+  /// @brief Block until all queued records are written and flushed to file
+  ///
+  void Flush();
+
+  ///
+  /// @brief Dropped record count getter
+  /// @return Number of records discarded due to a full queue
+  ///
+  unsigned int GetDropCount();
+
 private:
+  ///
+  /// @brief Queued record, either comma-separated text or a packed binary row
+  ///
+  struct QueuedRecord
+  {
+    std::string data;     ///< @brief Record contents
+    bool binary {false};  ///< @brief True if the contents are packed binary row doubles
+  };
+
+  LogFormat GetLogFormat();
+  uint64_t QueueCount();
+  bool ReserveSlot(uint64_t & head);
+  void CommitSlot(uint64_t head);
+  void OpenLogFile();
+  void StartWriter();
+  void StopWriter();
+  void WriteQueue();
+  void WriterLoop();
+
   bool m_initialized{false};
   std::string m_log_header{""};
   std::ofstream m_log_file;
@@ -95,6 +307,29 @@ private:
   double m_rate{0.0};
   double m_time_init{0};
   unsigned int m_log_count{0};
+
+  OverflowPolicy m_overflow_policy {OverflowPolicy::BLOCK};
+  bool m_overflow_policy_set {false};
+  LogFormat m_log_format {LogFormat::CSV};
+  bool m_log_format_set {false};
+  std::vector<std::string> m_columns;
+  DataRecord m_record;
+  unsigned int m_queue_size {4096U};
+  bool m_queue_size_set {false};
+  double m_flush_period {1.0};
+  bool m_flush_period_set {false};
+  std::vector<QueuedRecord> m_queue;
+  std::atomic<uint64_t> m_queue_head {0U};
+  std::atomic<uint64_t> m_queue_tail {0U};
+  bool m_stop_writer {false};
+  bool m_flush_requested {false};
+  std::atomic<unsigned int> m_drop_count {0U};
+  std::string m_write_buffer;
+  std::mutex m_writer_mutex;
+  std::mutex m_file_mutex;
+  std::condition_variable m_writer_cv;
+  std::condition_variable m_flush_cv;
+  std::thread m_writer_thread;
 };
 
 #endif  // INFRASTRUCTURE__DATA_LOGGER_HPP_
@@ -0,0 +1,98 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "infrastructure/binary_log.hpp"
+
+#include <eigen3/Eigen/Eigen>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST(binary_log, split_header) {
+  std::vector<std::string> columns = SplitHeader("time,pos_0,pos_1");
+  ASSERT_EQ(columns.size(), 3U);
+  EXPECT_EQ(columns[0], "time");
+  EXPECT_EQ(columns[2], "pos_1");
+  EXPECT_EQ(SplitHeader("").size(), 0U);
+}
+
+TEST(binary_log, append_row) {
+  std::string buffer;
+  AppendBinaryLogRow("1.5,-2e-3,abc", 4, buffer);
+  ASSERT_EQ(buffer.size(), 4 * sizeof(double));
+
+  const double * values = reinterpret_cast<const double *>(buffer.data());
+  EXPECT_EQ(values[0], 1.5);
+  EXPECT_EQ(values[1], -2e-3);
+  EXPECT_TRUE(std::isnan(values[2]));
+  EXPECT_TRUE(std::isnan(values[3]));
+}
+
+TEST(binary_log, binary_record) {
+  BinaryRecord record;
+  record.Append(0.1).Append(7U).Append(Eigen::Vector2d(1.0 / 3.0, -2.0));
+  record.Append(Eigen::Quaterniond(1.0, 0.0, 0.0, 0.0));
+  ASSERT_EQ(record.Bytes().size(), 8 * sizeof(double));
+
+  std::string buffer;
+  AppendBinaryLogValues(record.Bytes(), 9, buffer);
+  AppendBinaryLogValues(record.Bytes(), 2, buffer);
+  ASSERT_EQ(buffer.size(), 11 * sizeof(double));
+
+  const double * values = reinterpret_cast<const double *>(buffer.data());
+  EXPECT_EQ(values[0], 0.1);
+  EXPECT_EQ(values[1], 7.0);
+  EXPECT_EQ(values[2], 1.0 / 3.0);
+  EXPECT_EQ(values[3], -2.0);
+  EXPECT_EQ(values[4], 1.0);
+  EXPECT_TRUE(std::isnan(values[8]));
+  EXPECT_EQ(values[9], 0.1);
+  EXPECT_EQ(values[10], 7.0);
+
+  record.Clear();
+  EXPECT_TRUE(record.Bytes().empty());
+}
+
+TEST(binary_log, read_rows) {
+  std::vector<std::string> columns {"time", "value"};
+  {
+    std::ofstream file("binary_log_test.bin", std::ios::binary);
+    WriteBinaryLogHeader(file, columns);
+    std::string buffer;
+    AppendBinaryLogRow("0.1,10", 2, buffer);
+    AppendBinaryLogRow("0.2,20", 2, buffer);
+    file.write(buffer.data(), buffer.size());
+
+    // Partial trailing row
+    file.write(buffer.data(), sizeof(double));
+  }
+
+  BinaryLogReader reader("binary_log_test.bin");
+  ASSERT_TRUE(reader.IsValid());
+  EXPECT_EQ(reader.GetColumns(), columns);
+
+  std::vector<double> row;
+  ASSERT_TRUE(reader.ReadRow(row));
+  EXPECT_EQ(row, std::vector<double>({0.1, 10.0}));
+  ASSERT_TRUE(reader.ReadRow(row));
+  EXPECT_EQ(row, std::vector<double>({0.2, 20.0}));
+  EXPECT_FALSE(reader.ReadRow(row));
+
+  BinaryLogReader invalid_reader("binary_log_missing.bin");
+  EXPECT_FALSE(invalid_reader.IsValid());
+}
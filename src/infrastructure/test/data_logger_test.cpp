@@ -15,9 +15,16 @@
 
 #include "infrastructure/data_logger.hpp"
 
+#include <eigen3/Eigen/Eigen>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <fstream>
 #include <string>
+#include <vector>
+
+#include "infrastructure/binary_log.hpp"
+#include "utility/string_helper.hpp"
 
 TEST(data_logger, data_logger) {
   DataLogger data_logger;
@@ -29,3 +36,179 @@ TEST(data_logger, data_logger) {
   data_logger.SetLogging(true);
   data_logger.Log("a1,b1");
 }
+
+TEST(data_logger, queued_writes) {
+  DataLogger data_logger("", "data_logger_queued.csv");
+  data_logger.SetQueueSize(8U);
+  data_logger.DefineHeader("index");
+  data_logger.SetLogging(true);
+  for (unsigned int i = 0; i < 1000; ++i) {
+    data_logger.Log(std::to_string(i));
+  }
+  data_logger.Flush();
+
+  std::ifstream log_file("data_logger_queued.csv");
+  std::string line;
+  std::getline(log_file, line);
+  EXPECT_EQ(line, "index");
+  for (unsigned int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(std::getline(log_file, line));
+    EXPECT_EQ(line, std::to_string(i));
+  }
+  EXPECT_FALSE(std::getline(log_file, line));
+  EXPECT_EQ(data_logger.GetDropCount(), 0U);
+}
+
+TEST(data_logger, flush_wakes_writer) {
+  DataLogger data_logger("", "data_logger_flush.csv");
+  data_logger.SetFlushPeriod(60.0);
+  data_logger.DefineHeader("index");
+  data_logger.SetLogging(true);
+  data_logger.Log("0");
+
+  // Flush must not wait out the flush period
+  auto t_start = std::chrono::steady_clock::now();
+  data_logger.Flush();
+  EXPECT_LT(std::chrono::steady_clock::now() - t_start, std::chrono::seconds(10));
+
+  std::ifstream log_file("data_logger_flush.csv");
+  std::string line;
+  std::getline(log_file, line);
+  ASSERT_TRUE(std::getline(log_file, line));
+  EXPECT_EQ(line, "0");
+}
+
+TEST(data_logger, default_settings) {
+  DataLogger::SetDefaultOverflowPolicy(DataLogger::OverflowPolicy::DROP);
+  DataLogger::SetDefaultQueueSize(2U);
+  unsigned int drop_count {0U};
+  {
+    DataLogger data_logger("", "data_logger_defaults.csv");
+    data_logger.SetLogging(true);
+    for (unsigned int i = 0; i < 1000; ++i) {
+      data_logger.Log(std::to_string(i));
+    }
+    drop_count = data_logger.GetDropCount();
+  }
+  DataLogger::SetDefaultOverflowPolicy(DataLogger::OverflowPolicy::BLOCK);
+  DataLogger::SetDefaultQueueSize(4096U);
+  EXPECT_GT(drop_count, 0U);
+}
+
+TEST(data_logger, drop_policy) {
+  unsigned int line_count {0U};
+  unsigned int drop_count {0U};
+  {
+    DataLogger data_logger("", "data_logger_drop.csv");
+    data_logger.SetQueueSize(2U);
+    data_logger.SetOverflowPolicy(DataLogger::OverflowPolicy::DROP);
+    data_logger.SetLogging(true);
+    for (unsigned int i = 0; i < 1000; ++i) {
+      data_logger.Log(std::to_string(i));
+    }
+    drop_count = data_logger.GetDropCount();
+  }
+
+  // Destruction writes every record that was not dropped
+  std::ifstream log_file("data_logger_drop.csv");
+  std::string line;
+  std::getline(log_file, line);
+  while (std::getline(log_file, line)) {
+    ++line_count;
+  }
+  EXPECT_EQ(line_count + drop_count, 1000U);
+}
+
+TEST(data_logger, binary_format) {
+  {
+    DataLogger data_logger("", "data_logger_binary.csv");
+    data_logger.SetLogFormat(DataLogger::LogFormat::BINARY);
+    data_logger.DefineHeader("time,value");
+    data_logger.SetLogging(true);
+    data_logger.Log("1.0,2.0");
+    data_logger.Log("3.0,4.0");
+  }
+
+  BinaryLogReader reader("data_logger_binary.bin");
+  ASSERT_TRUE(reader.IsValid());
+  EXPECT_EQ(reader.GetColumns(), std::vector<std::string>({"time", "value"}));
+  std::vector<double> row;
+  ASSERT_TRUE(reader.ReadRow(row));
+  EXPECT_EQ(row, std::vector<double>({1.0, 2.0}));
+  ASSERT_TRUE(reader.ReadRow(row));
+  EXPECT_EQ(row, std::vector<double>({3.0, 4.0}));
+  EXPECT_FALSE(reader.ReadRow(row));
+}
+
+TEST(data_logger, log_due) {
+  DataLogger data_logger("", "data_logger_rate.csv", 10.0);
+  EXPECT_FALSE(data_logger.IsLogDue(0.0));
+
+  // First record sets the rate reference time
+  data_logger.SetLogging(true);
+  EXPECT_TRUE(data_logger.IsLogDue(1.0));
+  data_logger.Log("1.0");
+
+  unsigned int due_count {0U};
+  for (unsigned int i = 1; i <= 1000; ++i) {
+    double time = 1.0 + i * 1e-3;
+    if (data_logger.IsLogDue(time)) {
+      data_logger.Log(std::to_string(time));
+      ++due_count;
+    }
+  }
+  EXPECT_EQ(due_count, 9U);
+}
+
+TEST(data_logger, records) {
+  DataLogger data_logger("", "data_logger_records.csv");
+  data_logger.SetQueueSize(4U);
+  data_logger.SetPrecision(3U);
+  data_logger.DefineHeader("time,index,pos_x,pos_y");
+  data_logger.SetLogging(true);
+  for (unsigned int i = 0; i < 100; ++i) {
+    DataRecord & record = data_logger.NewRecord();
+    record.Append(i + 0.1234).Append(i).Append(Eigen::Vector2d(0.5, -0.25));
+    data_logger.LogRecord();
+  }
+  data_logger.Flush();
+
+  std::ifstream log_file("data_logger_records.csv");
+  std::string line;
+  std::getline(log_file, line);
+  EXPECT_EQ(line, "time,index,pos_x,pos_y");
+  ASSERT_TRUE(std::getline(log_file, line));
+  EXPECT_EQ(line, "0.123,0,0.5,-0.25");
+  ASSERT_TRUE(std::getline(log_file, line));
+  EXPECT_EQ(line, "1.12,1,0.5,-0.25");
+  unsigned int count {2U};
+  while (std::getline(log_file, line)) {
+    ++count;
+  }
+  EXPECT_EQ(count, 100U);
+}
+
+TEST(data_logger, binary_records) {
+  {
+    DataLogger data_logger("", "data_logger_binary_records.csv");
+    data_logger.SetLogFormat(DataLogger::LogFormat::BINARY);
+    data_logger.SetPrecision(3U);
+    data_logger.DefineHeader("time,index,pos_x,pos_y");
+    data_logger.SetLogging(true);
+    for (unsigned int i = 0; i < 100; ++i) {
+      DataRecord & record = data_logger.NewRecord();
+      record.Append(i + 0.1234).Append(i).Append(Eigen::Vector2d(1.0 / 3.0, -0.25));
+      data_logger.LogRecord();
+    }
+  }
+
+  // Binary rows keep full precision regardless of the CSV precision
+  BinaryLogReader reader("data_logger_binary_records.bin");
+  ASSERT_TRUE(reader.IsValid());
+  std::vector<double> row;
+  for (unsigned int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(reader.ReadRow(row));
+    EXPECT_EQ(row, std::vector<double>({i + 0.1234, static_cast<double>(i), 1.0 / 3.0, -0.25}));
+  }
+  EXPECT_FALSE(reader.ReadRow(row));
+}
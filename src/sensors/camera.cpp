@@ -17,8 +17,11 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <opencv2/opencv.hpp>
@@ -29,6 +32,7 @@
 #include "sensors/camera_message.hpp"
 #include "sensors/sensor.hpp"
 #include "trackers/feature_tracker.hpp"
+#include "trackers/tracking_pool.hpp"
 #include "utility/math_helper.hpp"
 
 
@@ -38,6 +42,7 @@ Camera::Camera(Camera::Parameters cam_params)
 {
   m_rate = cam_params.rate;
   m_intrinsics = cam_params.intrinsics;
+  m_async_tracking = cam_params.async_tracking;
 
   CamState cam_state;
   cam_state.pos_c_in_b = cam_params.pos_c_in_b;
@@ -48,6 +53,21 @@ Camera::Camera(Camera::Parameters cam_params)
   Eigen::MatrixXd cov = MinBoundVector(cam_params.variance, 1e-6).asDiagonal();
 
   m_ekf->RegisterCamera(m_id, cam_state, cov);
+
+  // The frame in the worker still needs its oldest clone after the next frame is augmented
+  if (m_async_tracking) {
+    m_ekf->SetCloneHeadroom(m_id, 1U);
+  }
+}
+
+Camera::~Camera()
+{
+  // Finish the in-flight and pending frames, then apply their queued updates
+  {
+    std::unique_lock<std::mutex> lock(m_frame_mutex);
+    m_frame_condition.wait(lock, [this] {return !m_job_active;});
+  }
+  ProcessTrackResults();
 }
 
 void Camera::Callback(std::shared_ptr<CameraMessage> camera_message)
@@ -60,14 +80,65 @@ void Camera::Callback(std::shared_ptr<CameraMessage> camera_message)
   if (!camera_message->image.empty()) {
     unsigned int frameID = GenerateFrameID();
 
-    m_ekf->AugmentState(m_id, frameID);
-
-    if (!m_trackers.empty()) {
+    if (!m_trackers.empty() && m_async_tracking) {
+      // Apply finished tracks before augmenting, so no clone they observe is marginalized
+      ProcessTrackResults();
+
+      if (!m_tracking_pool) {
+        m_tracking_pool = std::make_shared<TrackingPool>(1U);
+      }
+
+      bool submit_job {false};
+      bool frame_dropped {false};
+      unsigned int dropped_frame_id {0U};
+      {
+        std::lock_guard<std::mutex> lock(m_frame_mutex);
+        if (m_frame_pending) {
+          ++m_dropped_frames;
+          frame_dropped = true;
+          dropped_frame_id = m_pending_frame.frame_id;
+        }
+        m_pending_frame.time = camera_message->m_time;
+        m_pending_frame.frame_id = frameID;
+        m_pending_frame.image = camera_message->image;
+        m_pending_frame.body_ang_vel = m_ekf->GetBodyState().m_angular_velocity;
+        m_pending_frame.ang_c_to_b = m_ekf->GetCamState(m_id).ang_c_to_b;
+        m_frame_pending = true;
+
+        // Each camera has at most one job in the pool, keeping its tracker state serial
+        if (!m_job_active) {
+          m_job_active = true;
+          submit_job = true;
+        }
+        // Each worker output image is handed out once
+        if (!m_worker_out_img.empty()) {
+          m_out_img = m_worker_out_img;
+          m_worker_out_img.release();
+          m_out_img_updated = true;
+        }
+      }
+
+      // No track will reference the dropped frame, so its clone is removed from the state
+      if (frame_dropped) {
+        m_ekf->RemoveAugmentedState(m_id, dropped_frame_id);
+        m_logger->Log(
+          LogLevel::WARN, "Camera " + std::to_string(m_id) + " dropped frame " +
+          std::to_string(dropped_frame_id) + ", tracker busy");
+      }
+      m_ekf->AugmentState(m_id, frameID);
+
+      if (submit_job) {
+        m_tracking_pool->Submit([this]() {TrackPendingFrame();});
+      }
+    } else if (!m_trackers.empty()) {
+      m_ekf->AugmentState(m_id, frameID);
       m_trackers[0]->Track(camera_message->m_time, frameID, camera_message->image, m_out_img);
+      m_out_img_updated = m_draw_output;
 
       /// @todo Undistort points post track?
       // cv::undistortPoints();
     } else {
+      m_ekf->AugmentState(m_id, frameID);
       m_logger->Log(LogLevel::WARN, "Camera has no trackers");
     }
   } else {
@@ -78,6 +149,72 @@ void Camera::Callback(std::shared_ptr<CameraMessage> camera_message)
       camera_message->m_sensor_id) + " callback complete");
 }
 
+void Camera::TrackPendingFrame()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+    if (!m_frame_pending) {
+      m_job_active = false;
+      m_frame_condition.notify_all();
+      return;
+    }
+    std::swap(m_pending_frame, m_working_frame);
+    m_frame_pending = false;
+  }
+
+  std::shared_ptr<FeatureTracker> tracker = m_trackers[0];
+  double time = m_working_frame.time;
+  auto feature_tracks = std::make_shared<FeatureTracks>();
+  cv::Mat out_img;
+  tracker->DetectTracks(
+    time, m_working_frame.frame_id, m_working_frame.image, out_img,
+    m_working_frame.body_ang_vel, m_working_frame.ang_c_to_b, *feature_tracks);
+  m_working_frame.image.release();
+
+  m_tracking_pool->QueueUpdate(
+    time, [tracker, time, feature_tracks]() {tracker->UpdateTracks(time, *feature_tracks, false);});
+
+  // Yield the worker between frames so other cameras are served in turn
+  bool resubmit_job {false};
+  {
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+    m_worker_out_img = out_img;
+    resubmit_job = m_frame_pending;
+    m_job_active = resubmit_job;
+  }
+  if (resubmit_job) {
+    m_tracking_pool->Submit([this]() {TrackPendingFrame();});
+  } else {
+    m_frame_condition.notify_all();
+  }
+}
+
+void Camera::SetTrackingPool(std::shared_ptr<TrackingPool> tracking_pool)
+{
+  m_tracking_pool = tracking_pool;
+}
+
+void Camera::ProcessTrackResults()
+{
+  if (m_tracking_pool) {
+    m_tracking_pool->ProcessUpdates();
+  }
+}
+
+void Camera::SetDrawOutput(bool draw_output)
+{
+  m_draw_output = draw_output;
+  for (auto & tracker : m_trackers) {
+    tracker->SetDrawOutput(draw_output);
+  }
+}
+
+unsigned int Camera::GetDroppedFrames()
+{
+  std::lock_guard<std::mutex> lock(m_frame_mutex);
+  return m_dropped_frames;
+}
+
 /// @todo apply similar function to sensor/tracker IDs
 unsigned int Camera::GenerateFrameID()
 {
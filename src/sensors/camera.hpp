@@ -19,7 +19,9 @@
 #include <eigen3/Eigen/Eigen>
 
 #include <algorithm>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,6 +31,7 @@
 #include "sensors/sensor.hpp"
 #include "sensors/types.hpp"
 #include "trackers/feature_tracker.hpp"
+#include "trackers/tracking_pool.hpp"
 
 
 ///
@@ -55,6 +58,7 @@ public:
     std::string fiducial;                               ///< @brief Fiducial name
     std::string output_directory {""};                  ///< @brief IMU data logging directory
     bool data_logging_on {false};                       ///< @brief IMU data logging flag
+    bool async_tracking {false};                        ///< @brief Track frames on worker thread
     Intrinsics intrinsics;                              ///< @brief Camera intrinsics
     std::shared_ptr<DebugLogger> logger;                ///< @brief Debug logger
     std::shared_ptr<EKF> ekf;                           ///< @brief EKF to update
@@ -66,6 +70,11 @@ public:
   ///
   explicit Camera(Camera::Parameters cam_params);
 
+  ///
+  /// @brief Camera sensor destructor. Finishes queued frames and applies their updates
+  ///
+  ~Camera();
+
   ///
   /// @brief Method to add tracker object to camera sensor
   /// @param tracker Tracker pointer for camera to use during callbacks
@@ -78,15 +87,65 @@ public:
   ///
   void Callback(std::shared_ptr<CameraMessage> camera_message);
 
+  ///
+  /// @brief Enable or disable drawing of the tracker output image
+  /// @param draw_output Output image drawing flag
+  ///
+  void SetDrawOutput(bool draw_output);
+
+  ///
+  /// @brief Set the worker pool shared by asynchronous camera trackers
+  /// @param tracking_pool Tracking worker pool
+  ///
+  void SetTrackingPool(std::shared_ptr<TrackingPool> tracking_pool);
+
+  ///
+  /// @brief Filter stage applying completed asynchronous feature tracks in timestamp order
+  ///
+  void ProcessTrackResults();
+
+  ///
+  /// @brief Dropped frame count getter method
+  /// @return Number of frames dropped by the asynchronous intake
+  ///
+  unsigned int GetDroppedFrames();
+
 protected:
   unsigned int GenerateFrameID();
 
-  cv::Mat m_out_img;           ///< @brief Published output test image
-  std::shared_ptr<EKF> m_ekf;  ///< @brief EKF to update
+  cv::Mat m_out_img;               ///< @brief Published output test image
+  bool m_out_img_updated {false};  ///< @brief Output image was drawn since the last callback
+  bool m_draw_output {true};       ///< @brief Output image drawing flag
+  std::shared_ptr<EKF> m_ekf;      ///< @brief EKF to update
 
 private:
+  ///
+  /// @brief Frame waiting in the asynchronous intake
+  ///
+  typedef struct TrackingFrame
+  {
+    double time {0.0};                                  ///< @brief Frame time
+    unsigned int frame_id {0U};                         ///< @brief Frame ID
+    cv::Mat image;                                      ///< @brief Frame image
+    Eigen::Vector3d body_ang_vel {0.0, 0.0, 0.0};       ///< @brief Body angular rate at intake
+    Eigen::Quaterniond ang_c_to_b {1.0, 0.0, 0.0, 0.0};  ///< @brief Camera rotation at intake
+  } TrackingFrame;
+
+  void TrackPendingFrame();
+
   std::vector<std::shared_ptr<FeatureTracker>> m_trackers;
 
+  bool m_async_tracking {false};
+  std::shared_ptr<TrackingPool> m_tracking_pool;
+  std::mutex m_frame_mutex;
+  std::condition_variable m_frame_condition;
+  TrackingFrame m_pending_frame;
+  TrackingFrame m_working_frame;
+  bool m_frame_pending {false};
+  bool m_job_active {false};
+  unsigned int m_dropped_frames {0U};
+  cv::Mat m_worker_out_img;
+
   std::vector<double> m_rad_distortion_k{0.0, 0.0, 0.0};
   std::vector<double> m_tan_distortion_d{0.0, 0.0};
   Intrinsics m_intrinsics;
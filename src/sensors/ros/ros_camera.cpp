@@ -34,9 +34,13 @@ void RosCamera::Callback(std::shared_ptr<RosCameraMessage> ros_camera_message)
 {
   Camera::Callback(ros_camera_message);
 
-  m_logger->Log(LogLevel::DEBUG, "Image publish ROS");
-
-  m_out_ros_img = cv_bridge::CvImage(std_msgs::msg::Header(), "bgr8", m_out_img).toImageMsg();
+  // Only convert output images that are drawn and not yet published
+  m_out_ros_img.reset();
+  if (m_draw_output && m_out_img_updated && !m_out_img.empty()) {
+    m_logger->Log(LogLevel::DEBUG, "Image publish ROS");
+    m_out_ros_img = cv_bridge::CvImage(std_msgs::msg::Header(), "bgr8", m_out_img).toImageMsg();
+  }
+  m_out_img_updated = false;
 }
 
 sensor_msgs::msg::Image::SharedPtr RosCamera::GetRosImage()
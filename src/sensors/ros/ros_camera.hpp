@@ -45,7 +45,7 @@ public:
 
   ///
   /// @brief Camera output ROS image getter method
-  /// @return Camera output ROS image
+  /// @return Camera output ROS image of the last callback, or null if no new image was drawn
   ///
   sensor_msgs::msg::Image::SharedPtr GetRosImage();
 
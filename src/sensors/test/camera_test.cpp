@@ -15,9 +15,19 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <string>
 
+#include <opencv2/opencv.hpp>
+
+#include "ekf/ekf.hpp"
+#include "infrastructure/debug_logger.hpp"
+#include "sensors/camera.hpp"
+#include "sensors/camera_message.hpp"
 #include "trackers/feature_tracker.hpp"
+#include "trackers/tracking_pool.hpp"
 
 TEST(test_feature_tracker, initialization) {
   FeatureTracker::Parameters params;
@@ -51,3 +61,148 @@ TEST(test_feature_tracker, initialization) {
 
   EXPECT_EQ(feature_tracker_1.GetID(), 1U);
 }
+
+TEST(test_camera, async_tracking) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+
+  Camera::Parameters cam_params;
+  cam_params.async_tracking = true;
+  cam_params.logger = logger;
+  cam_params.ekf = ekf;
+  Camera camera {cam_params};
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = camera.GetId();
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.logger = logger;
+  params.ekf = ekf;
+  camera.AddTracker(std::make_shared<FeatureTracker>(params));
+
+  cv::Mat scene(560, 720, CV_8UC1);
+  cv::randu(scene, cv::Scalar(0), cv::Scalar(255));
+  cv::GaussianBlur(scene, scene, cv::Size(5, 5), 1.5);
+
+  for (int frame_id = 0; frame_id < 5; ++frame_id) {
+    auto camera_message = std::make_shared<CameraMessage>(
+      scene(cv::Rect(2 * frame_id, frame_id, 640, 480)).clone());
+    camera_message->m_sensor_id = camera.GetId();
+    camera_message->m_time = 0.1 * frame_id;
+    camera.Callback(camera_message);
+  }
+  camera.ProcessTrackResults();
+
+  // First frame always reaches the worker, later frames may be dropped under load
+  EXPECT_LE(camera.GetDroppedFrames(), 4U);
+
+  // Dropped frames leave no clone in the state
+  EXPECT_EQ(
+    ekf->GetCamState(camera.GetId()).augmented_states.size(), 5U - camera.GetDroppedFrames());
+}
+
+TEST(test_camera, async_max_length_tracks) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->SetMaxTrackLength(3U);
+
+  unsigned int camera_id {0U};
+  {
+    Camera::Parameters cam_params;
+    cam_params.async_tracking = true;
+    cam_params.logger = logger;
+    cam_params.ekf = ekf;
+    Camera camera {cam_params};
+    camera_id = camera.GetId();
+
+    FeatureTracker::Parameters params;
+    params.sensor_id = camera.GetId();
+    params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+    params.min_track_length = 3U;
+    params.max_track_length = 3U;
+    params.data_logging_on = true;
+    params.logger = logger;
+    params.ekf = ekf;
+    camera.AddTracker(std::make_shared<FeatureTracker>(params));
+
+    cv::Mat scene(560, 720, CV_8UC1);
+    cv::randu(scene, cv::Scalar(0), cv::Scalar(255));
+    cv::GaussianBlur(scene, scene, cv::Size(5, 5), 1.5);
+
+    // Frames arrive while the previous frame is still being tracked
+    for (int frame_id = 0; frame_id < 8; ++frame_id) {
+      auto camera_message = std::make_shared<CameraMessage>(
+        scene(cv::Rect(frame_id, frame_id, 640, 480)).clone());
+      camera_message->m_sensor_id = camera.GetId();
+      camera_message->m_time = 0.1 * frame_id;
+      camera.Callback(camera_message);
+    }
+  }
+
+  // Tracks spanning the maximum track length keep their clones and reach the MSCKF update
+  std::ifstream log_file("msckf_" + std::to_string(camera_id) + ".csv");
+  std::string line;
+  ASSERT_TRUE(std::getline(log_file, line));
+  std::stringstream header(line);
+  std::string column;
+  unsigned int track_column {0U};
+  while (std::getline(header, column, ',') && (column != "FeatureTracks")) {
+    ++track_column;
+  }
+  unsigned int track_count {0U};
+  while (std::getline(log_file, line)) {
+    std::stringstream row(line);
+    for (unsigned int i = 0; i <= track_column; ++i) {
+      std::getline(row, column, ',');
+    }
+    track_count += std::stoul(column);
+  }
+  EXPECT_GT(track_count, 0U);
+}
+
+TEST(test_camera, shared_tracking_pool) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  auto tracking_pool = std::make_shared<TrackingPool>(2U);
+
+  Camera::Parameters cam_params;
+  cam_params.async_tracking = true;
+  cam_params.logger = logger;
+  cam_params.ekf = ekf;
+  Camera camera_1 {cam_params};
+  Camera camera_2 {cam_params};
+
+  FeatureTracker::Parameters params;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.logger = logger;
+  params.ekf = ekf;
+  params.sensor_id = camera_1.GetId();
+  camera_1.AddTracker(std::make_shared<FeatureTracker>(params));
+  params.sensor_id = camera_2.GetId();
+  camera_2.AddTracker(std::make_shared<FeatureTracker>(params));
+  camera_1.SetTrackingPool(tracking_pool);
+  camera_2.SetTrackingPool(tracking_pool);
+
+  cv::Mat scene(560, 720, CV_8UC1);
+  cv::randu(scene, cv::Scalar(0), cv::Scalar(255));
+  cv::GaussianBlur(scene, scene, cv::Size(5, 5), 1.5);
+
+  for (int frame_id = 0; frame_id < 5; ++frame_id) {
+    auto message_1 = std::make_shared<CameraMessage>(
+      scene(cv::Rect(2 * frame_id, frame_id, 640, 480)).clone());
+    message_1->m_sensor_id = camera_1.GetId();
+    message_1->m_time = 0.1 * frame_id;
+    camera_1.Callback(message_1);
+
+    auto message_2 = std::make_shared<CameraMessage>(
+      scene(cv::Rect(frame_id, 2 * frame_id, 640, 480)).clone());
+    message_2->m_sensor_id = camera_2.GetId();
+    message_2->m_time = 0.1 * frame_id + 0.05;
+    camera_2.Callback(message_2);
+  }
+  tracking_pool->Wait();
+  camera_1.ProcessTrackResults();
+  EXPECT_EQ(tracking_pool->ProcessUpdates(), 0U);
+}
@@ -0,0 +1,239 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "trackers/feature_associator.hpp"
+
+#include <eigen3/Eigen/Eigen>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ekf/ekf.hpp"
+#include "ekf/types.hpp"
+#include "infrastructure/debug_logger.hpp"
+#include "sensors/types.hpp"
+
+FeatureAssociator::FeatureAssociator(
+  std::shared_ptr<EKF> ekf,
+  double association_window,
+  double epipolar_threshold,
+  std::shared_ptr<DebugLogger> logger)
+: m_ekf(ekf),
+  m_association_window(association_window),
+  m_epipolar_threshold(epipolar_threshold),
+  m_logger(logger)
+{}
+
+void FeatureAssociator::AddCamera(int camera_id, Intrinsics intrinsics)
+{
+  m_intrinsics[camera_id] = intrinsics;
+}
+
+Eigen::Vector3d FeatureAssociator::NormalizedBearing(
+  int camera_id,
+  const FeaturePoint & feature_point)
+{
+  const Intrinsics & intrinsics = m_intrinsics[camera_id];
+  Eigen::Vector3d bearing;
+  bearing(0) = (feature_point.key_point.pt.x - intrinsics.c_x) / intrinsics.f_x;
+  bearing(1) = (feature_point.key_point.pt.y - intrinsics.c_y) / intrinsics.f_y;
+  bearing(2) = 1.0;
+  return bearing;
+}
+
+double FeatureAssociator::EpipolarDistance(
+  int camera_a, const FeaturePoint & point_a,
+  int camera_b, const FeaturePoint & point_b)
+{
+  AugmentedState aug_state_a = m_ekf->MatchState(camera_a, point_a.frame_id);
+  AugmentedState aug_state_b = m_ekf->MatchState(camera_b, point_b.frame_id);
+
+  Eigen::Matrix3d rot_ca_to_g =
+    (aug_state_a.ang_b_to_g * aug_state_a.ang_c_to_b).toRotationMatrix();
+  Eigen::Matrix3d rot_cb_to_g =
+    (aug_state_b.ang_b_to_g * aug_state_b.ang_c_to_b).toRotationMatrix();
+  Eigen::Vector3d pos_ca_in_g = aug_state_a.ang_b_to_g * aug_state_a.pos_c_in_b +
+    aug_state_a.pos_b_in_g;
+  Eigen::Vector3d pos_cb_in_g = aug_state_b.ang_b_to_g * aug_state_b.pos_c_in_b +
+    aug_state_b.pos_b_in_g;
+
+  // Epipolar plane normal in the second camera frame
+  Eigen::Vector3d ray_a_in_g = rot_ca_to_g * NormalizedBearing(camera_a, point_a);
+  Eigen::Vector3d ray_b_in_g = rot_cb_to_g * NormalizedBearing(camera_b, point_b);
+  Eigen::Vector3d baseline_in_g = pos_cb_in_g - pos_ca_in_g;
+  Eigen::Vector3d normal_in_cb = rot_cb_to_g.transpose() * baseline_in_g.cross(ray_a_in_g);
+  double line_norm = normal_in_cb.head<2>().norm();
+  if (line_norm < 1e-12) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Closest approach of the two rays must lie in front of both cameras
+  double aa = ray_a_in_g.dot(ray_a_in_g);
+  double ab = ray_a_in_g.dot(ray_b_in_g);
+  double bb = ray_b_in_g.dot(ray_b_in_g);
+  double denominator = aa * bb - ab * ab;
+  if (std::abs(denominator) < 1e-12) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double depth_a = (bb * ray_a_in_g.dot(baseline_in_g) - ab * ray_b_in_g.dot(baseline_in_g)) /
+    denominator;
+  double depth_b = (ab * ray_a_in_g.dot(baseline_in_g) - aa * ray_b_in_g.dot(baseline_in_g)) /
+    denominator;
+  if ((depth_a <= 0.0) || (depth_b <= 0.0)) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return std::abs(normal_in_cb.dot(NormalizedBearing(camera_b, point_b))) / line_norm;
+}
+
+void FeatureAssociator::RemoveMarginalized(
+  int camera_id, std::vector<FeaturePoint> & feature_track)
+{
+  feature_track.erase(
+    std::remove_if(
+      feature_track.begin(), feature_track.end(),
+      [this, camera_id](const FeaturePoint & feature_point) {
+        int obs_camera_id = (feature_point.camera_id < 0) ? camera_id : feature_point.camera_id;
+        return !m_ekf->HasAugmentedState(obs_camera_id, feature_point.frame_id);
+      }),
+    feature_track.end());
+}
+
+bool FeatureAssociator::IsExpiring(
+  int camera_id, const std::vector<FeaturePoint> & feature_track)
+{
+  auto & cam_states = m_ekf->GetState().m_cam_states;
+  auto cam_iter = cam_states.find(camera_id);
+  if (feature_track.empty() || (cam_iter == cam_states.end()) ||
+    cam_iter->second.augmented_states.empty())
+  {
+    return true;
+  }
+
+  // The oldest clone is marginalized by the next augmentation once the camera is at capacity
+  const auto & aug_states = cam_iter->second.augmented_states;
+  return (aug_states.size() >= m_ekf->GetMaxCloneCount(camera_id)) &&
+         (feature_track.front().frame_id == aug_states.front().frame_id);
+}
+
+void FeatureAssociator::MergeTrack(
+  int camera_id, std::vector<FeaturePoint> & feature_track,
+  int other_id, const std::vector<FeaturePoint> & other_track)
+{
+  // Observations of the other camera are stored in this camera's pixel convention
+  const Intrinsics & intrinsics = m_intrinsics[camera_id];
+  for (auto const & other_point : other_track) {
+    Eigen::Vector3d bearing = NormalizedBearing(other_id, other_point);
+    FeaturePoint feature_point = other_point;
+    feature_point.key_point.pt.x =
+      static_cast<float>(bearing(0) * intrinsics.f_x + intrinsics.c_x);
+    feature_point.key_point.pt.y =
+      static_cast<float>(bearing(1) * intrinsics.f_y + intrinsics.c_y);
+    feature_point.key_point.class_id = feature_track.front().key_point.class_id;
+    feature_point.camera_id = other_id;
+    feature_track.push_back(feature_point);
+  }
+}
+
+void FeatureAssociator::Associate(int camera_id, double time, FeatureTracks & feature_tracks)
+{
+  FeatureTracks ready_tracks;
+  ready_tracks.reserve(feature_tracks.size());
+
+  // Waiting tracks lose observations whose clones were marginalized since they arrived
+  for (auto iter = m_pending_tracks.begin(); iter != m_pending_tracks.end(); ) {
+    RemoveMarginalized(iter->camera_id, iter->feature_track);
+    if (iter->feature_track.size() < 2) {
+      iter = m_pending_tracks.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  for (auto & feature_track : feature_tracks) {
+    RemoveMarginalized(camera_id, feature_track);
+    if (feature_track.size() < 2) {
+      continue;
+    }
+
+    // Closest waiting track of another camera on both ends of the track
+    double best_distance = m_epipolar_threshold;
+    auto best_iter = m_pending_tracks.end();
+    for (auto iter = m_pending_tracks.begin(); iter != m_pending_tracks.end(); ++iter) {
+      if (iter->camera_id == camera_id) {
+        continue;
+      }
+      double distance = std::max(
+        EpipolarDistance(
+          camera_id, feature_track.front(), iter->camera_id, iter->feature_track.front()),
+        EpipolarDistance(
+          camera_id, feature_track.back(), iter->camera_id, iter->feature_track.back()));
+      if (distance < best_distance) {
+        best_distance = distance;
+        best_iter = iter;
+      }
+    }
+
+    if (best_iter != m_pending_tracks.end()) {
+      MergeTrack(camera_id, feature_track, best_iter->camera_id, best_iter->feature_track);
+      m_pending_tracks.erase(best_iter);
+      ready_tracks.push_back(std::move(feature_track));
+      ++m_merged_count;
+    } else if ((m_association_window > 0.0) && !IsExpiring(camera_id, feature_track)) {
+      PendingTrack pending_track;
+      pending_track.camera_id = camera_id;
+      pending_track.time = time;
+      pending_track.feature_track = std::move(feature_track);
+      m_pending_tracks.push_back(std::move(pending_track));
+    } else {
+      ready_tracks.push_back(std::move(feature_track));
+    }
+  }
+
+  // Tracks of this camera that found no partner within the window, or that are about to lose
+  // their first clone, are updated alone
+  for (auto iter = m_pending_tracks.begin(); iter != m_pending_tracks.end(); ) {
+    if ((iter->camera_id == camera_id) &&
+      ((time - iter->time >= m_association_window) ||
+      IsExpiring(camera_id, iter->feature_track)))
+    {
+      ready_tracks.push_back(std::move(iter->feature_track));
+      iter = m_pending_tracks.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  feature_tracks.swap(ready_tracks);
+
+  m_logger->Log(
+    LogLevel::DEBUG, "Feature association for camera " + std::to_string(camera_id) + ": " +
+    std::to_string(feature_tracks.size()) + " ready, " +
+    std::to_string(m_pending_tracks.size()) + " waiting");
+}
+
+unsigned int FeatureAssociator::GetMergedCount()
+{
+  return m_merged_count;
+}
+
+unsigned int FeatureAssociator::GetPendingCount()
+{
+  return m_pending_tracks.size();
+}
@@ -0,0 +1,125 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TRACKERS__FEATURE_ASSOCIATOR_HPP_
+#define TRACKERS__FEATURE_ASSOCIATOR_HPP_
+
+#include <eigen3/Eigen/Eigen>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ekf/ekf.hpp"
+#include "ekf/types.hpp"
+#include "infrastructure/debug_logger.hpp"
+#include "sensors/types.hpp"
+
+///
+/// @class FeatureAssociator
+/// @brief Merges feature tracks of the same landmark seen by overlapping cameras
+///
+/// Completed tracks wait for up to an association window for a partner track from another
+/// camera. Tracks whose first and last observations satisfy the epipolar constraint between
+/// the camera clones in the EKF are merged into a single multi-camera track. A waiting track is
+/// released early when its first clone is next to be marginalized from the EKF, and
+/// observations of clones that were already marginalized are dropped.
+///
+class FeatureAssociator
+{
+public:
+  ///
+  /// @brief FeatureAssociator constructor
+  /// @param ekf EKF pointer
+  /// @param association_window Time a completed track waits for a partner track
+  /// @param epipolar_threshold Maximum epipolar distance in normalized image coordinates
+  /// @param logger Debug logger pointer
+  ///
+  FeatureAssociator(
+    std::shared_ptr<EKF> ekf,
+    double association_window,
+    double epipolar_threshold,
+    std::shared_ptr<DebugLogger> logger);
+
+  ///
+  /// @brief Register a camera taking part in association
+  /// @param camera_id Camera sensor ID
+  /// @param intrinsics Camera intrinsic parameters
+  ///
+  void AddCamera(int camera_id, Intrinsics intrinsics);
+
+  ///
+  /// @brief Associate newly completed tracks of a camera with waiting tracks of other cameras
+  /// @param camera_id Camera sensor ID of the new tracks
+  /// @param time Time of the new tracks
+  /// @param feature_tracks New tracks on input. Tracks ready for update on output
+  ///
+  void Associate(int camera_id, double time, FeatureTracks & feature_tracks);
+
+  ///
+  /// @brief Epipolar distance between two feature observations
+  /// @param camera_a Camera sensor ID of the first observation
+  /// @param point_a First observation
+  /// @param camera_b Camera sensor ID of the second observation
+  /// @param point_b Second observation
+  /// @return Distance from the epipolar line in normalized coordinates of the second camera.
+  /// Infinite if the baseline is degenerate or the rays do not meet in front of both cameras
+  ///
+  double EpipolarDistance(
+    int camera_a, const FeaturePoint & point_a,
+    int camera_b, const FeaturePoint & point_b);
+
+  ///
+  /// @brief Merged track count getter method
+  /// @return Number of tracks merged into multi-camera tracks
+  ///
+  unsigned int GetMergedCount();
+
+  ///
+  /// @brief Waiting track count getter method
+  /// @return Number of tracks waiting for a partner
+  ///
+  unsigned int GetPendingCount();
+
+private:
+  ///
+  /// @brief Completed track waiting for a partner
+  ///
+  typedef struct PendingTrack
+  {
+    int camera_id {-1};                       ///< @brief Camera sensor ID
+    double time {0.0};                        ///< @brief Completion time
+    std::vector<FeaturePoint> feature_track;  ///< @brief Feature track
+  } PendingTrack;
+
+  Eigen::Vector3d NormalizedBearing(int camera_id, const FeaturePoint & feature_point);
+
+  void RemoveMarginalized(int camera_id, std::vector<FeaturePoint> & feature_track);
+
+  bool IsExpiring(int camera_id, const std::vector<FeaturePoint> & feature_track);
+  void MergeTrack(
+    int camera_id, std::vector<FeaturePoint> & feature_track,
+    int other_id, const std::vector<FeaturePoint> & other_track);
+
+  std::shared_ptr<EKF> m_ekf;
+  double m_association_window {0.1};
+  double m_epipolar_threshold {0.01};
+  std::shared_ptr<DebugLogger> m_logger;
+  std::map<int, Intrinsics> m_intrinsics;
+  std::vector<PendingTrack> m_pending_tracks;
+  unsigned int m_merged_count {0U};
+};
+
+#endif  // TRACKERS__FEATURE_ASSOCIATOR_HPP_
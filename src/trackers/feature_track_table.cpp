@@ -0,0 +1,209 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "trackers/feature_track_table.hpp"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ekf/types.hpp"
+
+constexpr int FeatureTrackTable::EMPTY_KEY;
+
+FeatureTrackTable::FeatureTrackTable(unsigned int track_capacity, unsigned int initial_tracks)
+: m_track_capacity(std::max(track_capacity, 1U))
+{
+  Reserve(std::max(initial_tracks, 1U));
+}
+
+void FeatureTrackTable::Append(int feature_id, int frame_id, float u, float v)
+{
+  unsigned int index = FindIndex(feature_id);
+  if (m_keys[index] == EMPTY_KEY) {
+    if (m_free_slots.empty()) {
+      Reserve(2U * m_slots.size());
+      index = FindIndex(feature_id);
+    }
+    unsigned int slot = m_free_slots.back();
+    m_free_slots.pop_back();
+    m_slots[slot] = TrackSlot{feature_id, 0U, 0U};
+    m_keys[index] = feature_id;
+    m_key_slots[index] = slot;
+    ++m_size;
+  }
+
+  // Write into the ring, overwriting the oldest observation once full
+  unsigned int slot = m_key_slots[index];
+  TrackSlot & track = m_slots[slot];
+  unsigned int position = (track.start + track.count) % m_track_capacity;
+  m_observations[slot * m_track_capacity + position] = TrackObservation{frame_id, u, v};
+  if (track.count < m_track_capacity) {
+    ++track.count;
+  } else {
+    track.start = (track.start + 1U) % m_track_capacity;
+  }
+}
+
+void FeatureTrackTable::FindComplete(
+  int frame_id,
+  unsigned int max_length,
+  std::vector<int> & feature_ids)
+{
+  for (unsigned int i = 0; i < m_keys.size(); ++i) {
+    if (m_keys[i] == EMPTY_KEY) {
+      continue;
+    }
+    const TrackSlot & track = m_slots[m_key_slots[i]];
+    const TrackObservation & last = GetObservation(m_key_slots[i], track.count - 1U);
+    if ((last.frame_id < frame_id) || (track.count >= max_length)) {
+      feature_ids.push_back(m_keys[i]);
+    }
+  }
+
+  // Hash order is arbitrary, so output in feature order for repeatable updates
+  std::sort(feature_ids.begin(), feature_ids.end());
+}
+
+void FeatureTrackTable::PopTrack(int feature_id, std::vector<FeaturePoint> & feature_track)
+{
+  unsigned int index = FindIndex(feature_id);
+  if (m_keys[index] == EMPTY_KEY) {
+    return;
+  }
+
+  unsigned int slot = m_key_slots[index];
+  for (unsigned int i = 0; i < m_slots[slot].count; ++i) {
+    const TrackObservation & observation = GetObservation(slot, i);
+    FeaturePoint feature_point;
+    feature_point.frame_id = observation.frame_id;
+    feature_point.key_point.pt.x = observation.u;
+    feature_point.key_point.pt.y = observation.v;
+    feature_point.key_point.class_id = feature_id;
+    feature_track.push_back(feature_point);
+  }
+
+  Erase(feature_id);
+}
+
+void FeatureTrackTable::Erase(int feature_id)
+{
+  unsigned int index = FindIndex(feature_id);
+  if (m_keys[index] == EMPTY_KEY) {
+    return;
+  }
+  m_free_slots.push_back(m_key_slots[index]);
+  --m_size;
+
+  // Backward shift deletion keeps linear probe sequences intact without tombstones
+  unsigned int mask = m_keys.size() - 1U;
+  unsigned int next = index;
+  while (true) {
+    next = (next + 1U) & mask;
+    if (m_keys[next] == EMPTY_KEY) {
+      break;
+    }
+    unsigned int home = Home(m_keys[next]);
+    bool home_between = (index <= next) ?
+      ((index < home) && (home <= next)) :
+      ((index < home) || (home <= next));
+    if (!home_between) {
+      m_keys[index] = m_keys[next];
+      m_key_slots[index] = m_key_slots[next];
+      index = next;
+    }
+  }
+  m_keys[index] = EMPTY_KEY;
+}
+
+unsigned int FeatureTrackTable::GetTrackLength(int feature_id)
+{
+  unsigned int index = FindIndex(feature_id);
+  if (m_keys[index] == EMPTY_KEY) {
+    return 0U;
+  }
+  return m_slots[m_key_slots[index]].count;
+}
+
+unsigned int FeatureTrackTable::Size()
+{
+  return m_size;
+}
+
+unsigned int FeatureTrackTable::GetSlotCount()
+{
+  return m_slots.size();
+}
+
+void FeatureTrackTable::Reserve(unsigned int track_count)
+{
+  unsigned int slot_count = m_slots.size();
+  if (track_count > slot_count) {
+    m_slots.resize(track_count);
+    m_observations.resize(track_count * m_track_capacity);
+    m_free_slots.reserve(track_count);
+    for (unsigned int slot = track_count; slot > slot_count; --slot) {
+      m_free_slots.push_back(slot - 1U);
+    }
+  }
+
+  // Keep the index at most half full
+  unsigned int index_size = 1U;
+  while (index_size < 2U * track_count) {
+    index_size <<= 1U;
+  }
+  if (index_size > m_keys.size()) {
+    Rehash(index_size);
+  }
+}
+
+void FeatureTrackTable::Rehash(unsigned int index_size)
+{
+  std::vector<int> keys(index_size, EMPTY_KEY);
+  std::vector<unsigned int> key_slots(index_size, 0U);
+  keys.swap(m_keys);
+  key_slots.swap(m_key_slots);
+  for (unsigned int i = 0; i < keys.size(); ++i) {
+    if (keys[i] != EMPTY_KEY) {
+      unsigned int index = FindIndex(keys[i]);
+      m_keys[index] = keys[i];
+      m_key_slots[index] = key_slots[i];
+    }
+  }
+}
+
+unsigned int FeatureTrackTable::Home(int feature_id)
+{
+  // Multiplication by an odd constant permutes the low bits of sequential IDs
+  return (static_cast<uint32_t>(feature_id) * 2654435761U) & (m_keys.size() - 1U);
+}
+
+unsigned int FeatureTrackTable::FindIndex(int feature_id)
+{
+  unsigned int mask = m_keys.size() - 1U;
+  unsigned int index = Home(feature_id);
+  while ((m_keys[index] != EMPTY_KEY) && (m_keys[index] != feature_id)) {
+    index = (index + 1U) & mask;
+  }
+  return index;
+}
+
+const FeatureTrackTable::TrackObservation & FeatureTrackTable::GetObservation(
+  unsigned int slot,
+  unsigned int index)
+{
+  return m_observations[slot * m_track_capacity + (m_slots[slot].start + index) % m_track_capacity];
+}
@@ -0,0 +1,124 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TRACKERS__FEATURE_TRACK_TABLE_HPP_
+#define TRACKERS__FEATURE_TRACK_TABLE_HPP_
+
+#include <vector>
+
+#include "ekf/types.hpp"
+
+///
+/// @class FeatureTrackTable
+/// @brief Open-addressing table of live feature tracks stored in fixed-capacity ring slots
+///
+class FeatureTrackTable
+{
+public:
+  ///
+  /// @brief Compact feature observation
+  ///
+  typedef struct TrackObservation
+  {
+    int frame_id {-1};  ///< @brief Observation frame ID
+    float u {0.0f};     ///< @brief Observation x pixel coordinate
+    float v {0.0f};     ///< @brief Observation y pixel coordinate
+  } TrackObservation;
+
+  ///
+  /// @brief FeatureTrackTable constructor
+  /// @param track_capacity Maximum observations held per track
+  /// @param initial_tracks Number of track slots to preallocate
+  ///
+  explicit FeatureTrackTable(unsigned int track_capacity = 20U, unsigned int initial_tracks = 256U);
+
+  ///
+  /// @brief Append an observation to a feature track, creating the track if needed
+  /// @param feature_id Feature ID
+  /// @param frame_id Observation frame ID
+  /// @param u Observation x pixel coordinate
+  /// @param v Observation y pixel coordinate
+  ///
+  void Append(int feature_id, int frame_id, float u, float v);
+
+  ///
+  /// @brief Find tracks not observed in a frame or at their maximum length
+  /// @param frame_id Latest frame ID
+  /// @param max_length Track length at which a track is complete
+  /// @param feature_ids Output feature IDs of complete tracks in ascending order
+  ///
+  void FindComplete(int frame_id, unsigned int max_length, std::vector<int> & feature_ids);
+
+  ///
+  /// @brief Copy a track into a feature point vector and remove it from the table
+  /// @param feature_id Feature ID
+  /// @param feature_track Output feature track, appended in observation order
+  ///
+  void PopTrack(int feature_id, std::vector<FeaturePoint> & feature_track);
+
+  ///
+  /// @brief Remove a track from the table
+  /// @param feature_id Feature ID
+  ///
+  void Erase(int feature_id);
+
+  ///
+  /// @brief Track length getter method
+  /// @param feature_id Feature ID
+  /// @return Number of observations in the track, zero if the track does not exist
+  ///
+  unsigned int GetTrackLength(int feature_id);
+
+  ///
+  /// @brief Live track count getter method
+  /// @return Number of live tracks
+  ///
+  unsigned int Size();
+
+  ///
+  /// @brief Track slot count getter method
+  /// @return Number of preallocated track slots
+  ///
+  unsigned int GetSlotCount();
+
+private:
+  ///
+  /// @brief Ring slot bookkeeping of a single track
+  ///
+  typedef struct TrackSlot
+  {
+    int feature_id {-1};      ///< @brief Feature ID
+    unsigned int start {0U};  ///< @brief Ring index of the oldest observation
+    unsigned int count {0U};  ///< @brief Number of observations
+  } TrackSlot;
+
+  void Reserve(unsigned int track_count);
+  void Rehash(unsigned int index_size);
+  unsigned int Home(int feature_id);
+  unsigned int FindIndex(int feature_id);
+  const TrackObservation & GetObservation(unsigned int slot, unsigned int index);
+
+  static constexpr int EMPTY_KEY {-1};
+
+  unsigned int m_track_capacity;
+  unsigned int m_size {0U};
+  std::vector<int> m_keys;
+  std::vector<unsigned int> m_key_slots;
+  std::vector<TrackSlot> m_slots;
+  std::vector<TrackObservation> m_observations;
+  std::vector<unsigned int> m_free_slots;
+};
+
+#endif  // TRACKERS__FEATURE_TRACK_TABLE_HPP_
@@ -18,17 +18,27 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <eigen3/Eigen/Eigen>
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <opencv2/core/hal/hal.hpp>
 #include <opencv2/features2d.hpp>
 #include <opencv2/opencv.hpp>
 
 #include "ekf/types.hpp"
 #include "sensors/types.hpp"
+#include "utility/string_helper.hpp"
+#include "utility/type_helper.hpp"
 
 // Initialize static variable
 unsigned int FeatureTracker::m_tracker_count = 0;
@@ -37,14 +47,44 @@ unsigned int FeatureTracker::m_tracker_count = 0;
 FeatureTracker::FeatureTracker(FeatureTracker::Parameters params)
 : m_msckf_updater(params.sensor_id, params.intrinsics, params.output_directory,
     params.data_logging_on, params.data_log_rate, params.min_feat_dist, params.logger),
-  m_camera_id(params.sensor_id), m_id(++m_tracker_count), m_ekf(params.ekf), m_logger(params.logger)
+  m_camera_id(params.sensor_id), m_id(++m_tracker_count), m_ekf(params.ekf), m_logger(params.logger),
+  m_budget_logger(params.output_directory, "tracker_" + std::to_string(params.sensor_id) + ".csv")
 {
   m_feature_detector = InitFeatureDetector(params.detector, params.threshold);
   m_descriptor_extractor = InitDescriptorExtractor(params.descriptor, params.threshold);
-  m_descriptor_matcher = InitDescriptorMatcher(params.matcher);
+  m_descriptor_norm = m_descriptor_extractor->defaultNorm();
   m_px_error = params.px_error;
   m_min_track_length = params.min_track_length;
   m_max_track_length = params.max_track_length;
+  m_track_table = FeatureTrackTable(m_max_track_length);
+  m_tracking_mode = params.tracking_mode;
+  m_gyro_prediction = params.gyro_prediction;
+  m_intrinsics = params.intrinsics;
+  m_mutual_check = params.mutual_check;
+  m_nms_cell_size = params.nms_cell_size;
+  m_nms_cell_quota = params.nms_cell_quota;
+  m_ratio_test = params.ratio_test;
+  m_klt_window_size = params.klt_window_size;
+  m_klt_pyramid_levels = params.klt_pyramid_levels;
+  m_klt_max_error = params.klt_max_error;
+  m_image_width = params.image_width;
+  m_image_height = params.image_height;
+  m_roi = params.roi;
+  m_max_features = std::max(params.max_features, 1U);
+  m_min_features = std::min(params.min_features, m_max_features);
+  m_feature_budget = m_max_features;
+  m_target_frame_time = params.target_frame_time;
+  m_target_track_count = params.target_track_count;
+  m_detector_threshold = params.threshold;
+  m_max_detector_threshold = 4.0 * std::max(params.threshold, 1.0);
+  m_budget_logger.DefineHeader(
+    "time,frame_time,update_time,key_points,tracked,feature_budget,detector_threshold");
+  m_budget_logger.SetLogging(params.data_logging_on);
+  m_budget_logger.SetLogRate(params.data_log_rate);
+  m_msckf_updater.SetBatchTriangulation(params.batch_triangulation);
+  m_msckf_updater.SetTriangulationMethod(params.triangulation_method);
+  m_msckf_updater.SetUpdateBudget(params.max_update_rows, params.max_update_time);
+  m_msckf_updater.SetChiSquaredGating(params.chi_squared_gating);
 }
 
 /// @todo Check what parameters are used by open_vins
@@ -102,167 +142,551 @@ cv::Ptr<cv::DescriptorExtractor> FeatureTracker::InitDescriptorExtractor(
 }
 
 
-cv::Ptr<cv::DescriptorMatcher> FeatureTracker::InitDescriptorMatcher(DescriptorMatcherEnum matcher)
+void FeatureTracker::BucketFeatures(
+  std::vector<cv::KeyPoint> & key_points,
+  unsigned int rows,
+  unsigned int cols)
 {
-  cv::Ptr<cv::DescriptorMatcher> descriptor_matcher;
-  switch (matcher) {
-    case DescriptorMatcherEnum::BRUTE_FORCE:
-      descriptor_matcher = cv::BFMatcher::create();
-      break;
-    case DescriptorMatcherEnum::FLANN:
-      descriptor_matcher = cv::FlannBasedMatcher::create();
-      break;
+  double cell_size = static_cast<double>(std::max(m_nms_cell_size, 1U));
+  unsigned int grid_cols = static_cast<unsigned int>(std::ceil(cols / cell_size));
+
+  // Assign in-bounds key points to cells
+  m_bucket_order.clear();
+  m_bucket_cells.resize(key_points.size());
+  for (unsigned int i = 0; i < key_points.size(); ++i) {
+    const cv::Point2f & pt = key_points[i].pt;
+    if (pt.x < 0 || pt.y < 0 || pt.x >= cols || pt.y >= rows) {
+      continue;
+    }
+    unsigned int x_grid = static_cast<unsigned int>(pt.x / cell_size);
+    unsigned int y_grid = static_cast<unsigned int>(pt.y / cell_size);
+    m_bucket_cells[i] = y_grid * grid_cols + x_grid;
+    m_bucket_order.push_back(i);
+  }
+
+  // Order by cell, strongest response first within each cell
+  std::sort(
+    m_bucket_order.begin(), m_bucket_order.end(),
+    [this, &key_points](unsigned int a, unsigned int b) {
+      if (m_bucket_cells[a] != m_bucket_cells[b]) {
+        return m_bucket_cells[a] < m_bucket_cells[b];
+      }
+      return key_points[a].response > key_points[b].response;
+    });
+
+  // Keep the top responses of each cell
+  m_bucket_key_points.clear();
+  unsigned int cell_count {0U};
+  for (unsigned int k = 0; k < m_bucket_order.size(); ++k) {
+    unsigned int i = m_bucket_order[k];
+    if (k == 0 || m_bucket_cells[i] != m_bucket_cells[m_bucket_order[k - 1]]) {
+      cell_count = 0;
+    }
+    if (cell_count < m_nms_cell_quota) {
+      m_bucket_key_points.push_back(key_points[i]);
+      ++cell_count;
+    }
+  }
+
+  key_points.swap(m_bucket_key_points);
+}
+
+cv::Mat FeatureTracker::PreprocessImage(const cv::Mat & img_in)
+{
+  // Crop as a view into the input buffer
+  cv::Mat img = img_in;
+  m_roi_offset = cv::Point2f(0.0, 0.0);
+  if (m_roi.area() > 0) {
+    cv::Rect roi = m_roi & cv::Rect(0, 0, img_in.cols, img_in.rows);
+    if (roi.area() > 0) {
+      img = img_in(roi);
+      m_roi_offset = cv::Point2f(roi.x, roi.y);
+    }
+  }
+
+  // Convert to grayscale once for detection, description, and optical flow
+  if (img.channels() == 3) {
+    cv::cvtColor(img, m_gray_buffer, cv::COLOR_BGR2GRAY);
+    img = m_gray_buffer;
+  } else if (img.channels() == 4) {
+    cv::cvtColor(img, m_gray_buffer, cv::COLOR_BGRA2GRAY);
+    img = m_gray_buffer;
+  }
+
+  // Only resample when a target resolution is set and differs from the input
+  m_scale_x = 1.0;
+  m_scale_y = 1.0;
+  if ((m_image_width > 0) && (m_image_height > 0) &&
+    ((img.cols != static_cast<int>(m_image_width)) ||
+    (img.rows != static_cast<int>(m_image_height))))
+  {
+    m_scale_x = static_cast<double>(m_image_width) / img.cols;
+    m_scale_y = static_cast<double>(m_image_height) / img.rows;
+    cv::resize(
+      img, m_resize_buffer, cv::Size(m_image_width, m_image_height), 0, 0, cv::INTER_AREA);
+    img = m_resize_buffer;
+  }
+
+  return img;
+}
+
+void FeatureTracker::AdaptFeatureBudget(double frame_time, unsigned int tracked_count)
+{
+  if (m_target_frame_time <= 0.0) {
+    return;
+  }
+
+  // Multiplicative correction toward the target latency, damped to avoid oscillation
+  double scale = m_target_frame_time / std::max(frame_time, 1e-6);
+  scale = std::min(std::max(scale, 0.5), 1.25);
+
+  // Enough features are tracked, so spare latency is not spent on more features
+  if ((m_target_track_count > 0U) && (tracked_count >= m_target_track_count)) {
+    scale = std::min(scale, 1.0);
+  }
+
+  double budget = std::round(m_feature_budget * scale);
+  m_feature_budget = static_cast<unsigned int>(
+    std::min(std::max(budget, static_cast<double>(m_min_features)),
+    static_cast<double>(m_max_features)));
+
+  // Detection cost is set by the detector, so tighten its threshold when over budget
+  cv::Ptr<cv::FastFeatureDetector> fast_detector =
+    m_feature_detector.dynamicCast<cv::FastFeatureDetector>();
+  cv::Ptr<cv::ORB> orb_detector = m_feature_detector.dynamicCast<cv::ORB>();
+  if (fast_detector) {
+    if (scale < 1.0) {
+      m_detector_threshold = std::min(m_detector_threshold + 1.0, m_max_detector_threshold);
+    } else if (scale > 1.0) {
+      m_detector_threshold = std::max(m_detector_threshold - 1.0, 1.0);
+    }
+    fast_detector->setThreshold(static_cast<int>(m_detector_threshold));
+  } else if (orb_detector) {
+    orb_detector->setMaxFeatures(m_feature_budget);
   }
 
-  return descriptor_matcher;
+  m_logger->Log(
+    LogLevel::DEBUG, "Tracker " + std::to_string(m_id) + " feature budget: " +
+    std::to_string(m_feature_budget) + ", threshold: " + std::to_string(m_detector_threshold) +
+    ", frame time: " + std::to_string(frame_time));
 }
 
-/// @todo Do keypoint vector editing in place
-std::vector<cv::KeyPoint> FeatureTracker::GridFeatures(
-  std::vector<cv::KeyPoint> key_points,
+unsigned int FeatureTracker::GetFeatureBudget()
+{
+  return m_feature_budget;
+}
+
+void FeatureTracker::SetDrawOutput(bool draw_output)
+{
+  m_draw_output = draw_output;
+}
+
+void FeatureTracker::SetFeatureAssociator(std::shared_ptr<FeatureAssociator> feature_associator)
+{
+  m_feature_associator = feature_associator;
+}
+
+cv::Point2f FeatureTracker::ToInputPoint(const cv::Point2f & point)
+{
+  return cv::Point2f(
+    point.x / m_scale_x + m_roi_offset.x,
+    point.y / m_scale_y + m_roi_offset.y);
+}
+
+cv::Point2f FeatureTracker::ToImagePoint(const cv::Point2f & point)
+{
+  return cv::Point2f(
+    (point.x - m_roi_offset.x) * m_scale_x,
+    (point.y - m_roi_offset.y) * m_scale_y);
+}
+
+std::vector<cv::Point2f> FeatureTracker::PredictKeyPoints(double time)
+{
+  return PredictKeyPoints(
+    time,
+    m_ekf->GetBodyState().m_angular_velocity,
+    m_ekf->GetCamState(m_camera_id).ang_c_to_b);
+}
+
+std::vector<cv::Point2f> FeatureTracker::PredictKeyPoints(
+  double time,
+  const Eigen::Vector3d & body_ang_vel,
+  const Eigen::Quaterniond & ang_c_to_b)
+{
+  std::vector<cv::Point2f> predicted_points;
+  cv::KeyPoint::convert(m_prev_key_points, predicted_points);
+
+  if (!m_gyro_prediction || (m_prev_time < 0.0) || (time <= m_prev_time)) {
+    return predicted_points;
+  }
+
+  // Camera rotation between frames from integrated body angular rate
+  Eigen::Matrix3d rot_c_to_b = ang_c_to_b.toRotationMatrix();
+  Eigen::Matrix3d rot_b1_to_b0 =
+    RotVecToQuat(body_ang_vel * (time - m_prev_time)).toRotationMatrix();
+  Eigen::Matrix3d rot_c0_to_c1 = rot_c_to_b.transpose() * rot_b1_to_b0.transpose() * rot_c_to_b;
+
+  // Rotation-only homography; translation is unobservable without depth
+  // Intrinsics are defined on the input frame, not the preprocessed frame
+  for (auto & point : predicted_points) {
+    cv::Point2f input_point = ToInputPoint(point);
+    Eigen::Vector3d uv_c0 {
+      (input_point.x - m_intrinsics.c_x) / m_intrinsics.f_x,
+      (input_point.y - m_intrinsics.c_y) / m_intrinsics.f_y,
+      1.0};
+    Eigen::Vector3d uv_c1 = rot_c0_to_c1 * uv_c0;
+    if (uv_c1(2) > 0) {
+      input_point.x = m_intrinsics.f_x * uv_c1(0) / uv_c1(2) + m_intrinsics.c_x;
+      input_point.y = m_intrinsics.f_y * uv_c1(1) / uv_c1(2) + m_intrinsics.c_y;
+      point = ToImagePoint(input_point);
+    }
+  }
+
+  return predicted_points;
+}
+
+std::vector<cv::DMatch> FeatureTracker::MatchPredictedWindows(
+  const std::vector<cv::Point2f> & predicted_points,
+  double search_radius,
   unsigned int rows,
   unsigned int cols)
 {
-  unsigned int min_pixel_distance = 10;
-  double double_rows = static_cast<double>(rows);
-  double double_cols = static_cast<double>(cols);
-  double double_min_pixel_distance = static_cast<double>(min_pixel_distance);
-  unsigned int grid_rows = static_cast<unsigned int>(double_rows / double_min_pixel_distance);
-  unsigned int grid_cols = static_cast<unsigned int>(double_cols / double_min_pixel_distance);
-  cv::Size size(grid_cols, grid_rows);
-
-  /// @todo replace this with some kind of boolean array. Eigen?
-  // Eigen::Array<bool, 1, 5> false_array(5);
-  // false_array = Array<bool, 1, 5>::Zero(5);
-
-  /// @todo Implement non-maximal suppression instead
-
-  cv::Mat grid_2d = cv::Mat::zeros(size, CV_8UC1);
-
-  std::vector<cv::KeyPoint> grid_key_points;
-  for (size_t i = 0; i < key_points.size(); i++) {
-    // Get current left keypoint, check that it is in bounds
-    cv::KeyPoint kpt = key_points.at(i);
-    int x = static_cast<int>(kpt.pt.x);
-    int y = static_cast<int>(kpt.pt.y);
-    int x_grid = static_cast<int>(kpt.pt.x / double_min_pixel_distance);
-    int y_grid = static_cast<int>(kpt.pt.y / double_min_pixel_distance);
-    if (x_grid < 0 || x_grid >= size.width || y_grid < 0 || y_grid >= size.height || x < 0 ||
-      x >= static_cast<int>(cols) || y < 0 || y >= static_cast<int>(rows))
-    {
-      continue;
+  // Bucket current key points in a uniform grid of search radius cells
+  double cell_size = std::max(search_radius, 1.0);
+  int grid_cols = static_cast<int>(cols / cell_size) + 1;
+  int grid_rows = static_cast<int>(rows / cell_size) + 1;
+  m_match_grid.resize(grid_rows * grid_cols);
+  for (auto & cell : m_match_grid) {
+    cell.clear();
+  }
+  for (unsigned int j = 0; j < m_curr_key_points.size(); ++j) {
+    int x_grid = static_cast<int>(m_curr_key_points[j].pt.x / cell_size);
+    int y_grid = static_cast<int>(m_curr_key_points[j].pt.y / cell_size);
+    if (x_grid >= 0 && x_grid < grid_cols && y_grid >= 0 && y_grid < grid_rows) {
+      m_match_grid[y_grid * grid_cols + x_grid].push_back(j);
+    }
+  }
+
+  // Best previous key point for each current key point, for the mutual check
+  std::vector<cv::DMatch> reverse_matches(
+    m_curr_key_points.size(), cv::DMatch(-1, -1, std::numeric_limits<float>::max()));
+
+  // Compare each previous descriptor only against key points near its prediction
+  std::vector<cv::DMatch> forward_matches;
+  forward_matches.reserve(predicted_points.size());
+  for (unsigned int i = 0; i < predicted_points.size(); ++i) {
+    const cv::Point2f & point = predicted_points[i];
+    int x_min = std::max(static_cast<int>((point.x - search_radius) / cell_size), 0);
+    int x_max = std::min(static_cast<int>((point.x + search_radius) / cell_size), grid_cols - 1);
+    int y_min = std::max(static_cast<int>((point.y - search_radius) / cell_size), 0);
+    int y_max = std::min(static_cast<int>((point.y + search_radius) / cell_size), grid_rows - 1);
+
+    cv::DMatch best_match(i, -1, std::numeric_limits<float>::max());
+    float second_distance = std::numeric_limits<float>::max();
+    for (int y_grid = y_min; y_grid <= y_max; ++y_grid) {
+      for (int x_grid = x_min; x_grid <= x_max; ++x_grid) {
+        for (auto j : m_match_grid[y_grid * grid_cols + x_grid]) {
+          cv::Point2f delta = m_curr_key_points[j].pt - point;
+          if (delta.dot(delta) > search_radius * search_radius) {
+            continue;
+          }
+          float distance = DescriptorDistance(i, j);
+          if (distance < best_match.distance) {
+            second_distance = best_match.distance;
+            best_match.trainIdx = j;
+            best_match.distance = distance;
+          } else if (distance < second_distance) {
+            second_distance = distance;
+          }
+          if (distance < reverse_matches[j].distance) {
+            reverse_matches[j].queryIdx = i;
+            reverse_matches[j].distance = distance;
+          }
+        }
+      }
     }
-    // Check if this keypoint is near another point
-    if (grid_2d.at<uint8_t>(y_grid, x_grid) > 127) {
+
+    // Lowe ratio test against the second best candidate in the window
+    if (best_match.trainIdx < 0 ||
+      (m_ratio_test > 0.0 && best_match.distance > m_ratio_test * second_distance))
+    {
       continue;
     }
-    // Else we are good, append our key_points and descriptors
-    grid_key_points.push_back(key_points.at(i));
+    forward_matches.push_back(best_match);
+  }
 
-    grid_2d.at<uint8_t>(y_grid, x_grid) = 255;
+  if (!m_mutual_check) {
+    return forward_matches;
   }
-  return grid_key_points;
+
+  // Keep only matches that are also the best for the current key point
+  std::vector<cv::DMatch> mutual_matches;
+  mutual_matches.reserve(forward_matches.size());
+  for (const auto & match : forward_matches) {
+    if (reverse_matches[match.trainIdx].queryIdx == match.queryIdx) {
+      mutual_matches.push_back(match);
+    }
+  }
+
+  return mutual_matches;
 }
 
-void FeatureTracker::Track(double time, int frame_id, cv::Mat & img_in, cv::Mat & img_out)
+float FeatureTracker::DescriptorDistance(unsigned int prev_index, unsigned int curr_index)
 {
-  // Down sample image
-  cv::Mat img_down;
-  cv::Size down_sample_size;
-  down_sample_size.height = 480;
-  down_sample_size.width = 640;
-  cv::resize(img_in, img_down, down_sample_size);
-  FeatureTracks feature_tracks;
+  // Binary descriptors stay packed and use the popcount Hamming kernel
+  if (m_descriptor_norm == cv::NORM_HAMMING) {
+    return static_cast<float>(
+      cv::hal::normHamming(
+        m_prev_descriptors.ptr<uchar>(prev_index),
+        m_curr_descriptors.ptr<uchar>(curr_index),
+        m_curr_descriptors.cols));
+  }
+  return static_cast<float>(
+    cv::norm(
+      m_prev_descriptors.row(prev_index), m_curr_descriptors.row(curr_index),
+      m_descriptor_norm));
+}
 
-  m_feature_detector->detect(img_down, m_curr_key_points);
-  /// @todo create occupancy grid of key_points using minimal pixel distance
-  m_curr_key_points = GridFeatures(m_curr_key_points, img_down.rows, img_down.cols);
+bool FeatureTracker::TrackDescriptors(
+  const std::vector<cv::Point2f> & predicted_points,
+  const cv::Mat & img,
+  cv::Mat & img_out)
+{
+  m_feature_detector->detect(img, m_curr_key_points);
+  BucketFeatures(m_curr_key_points, img.rows, img.cols);
+  cv::KeyPointsFilter::retainBest(m_curr_key_points, m_feature_budget);
 
-  double threshold_dist =
-    0.25 * sqrt(static_cast<double>(down_sample_size.height + down_sample_size.width));
+  double threshold_dist = 0.25 * sqrt(static_cast<double>(img.rows + img.cols));
 
-  m_descriptor_extractor->compute(img_down, m_curr_key_points, m_curr_descriptors);
-  m_curr_descriptors.convertTo(m_curr_descriptors, CV_32F);
-  cv::drawKeypoints(img_down, m_curr_key_points, img_out);
+  m_descriptor_extractor->compute(img, m_curr_key_points, m_curr_descriptors);
+  if (m_draw_output) {
+    cv::drawKeypoints(img, m_curr_key_points, img_out);
+  }
 
-  m_logger->Log(LogLevel::DEBUG, "Called Tracker for frame ID: " + std::to_string(frame_id));
+  if (m_prev_descriptors.rows == 0 || m_curr_descriptors.rows == 0) {
+    return false;
+  }
 
-  if (m_prev_descriptors.rows > 0 && m_curr_descriptors.rows > 0) {
-    std::vector<std::vector<cv::DMatch>> matches_forward, matches_backward;
-    std::vector<cv::DMatch> matches_good;
-
-    /// @todo Mask using maximum distance from predicted IMU rotations
-    m_descriptor_matcher->knnMatch(m_prev_descriptors, m_curr_descriptors, matches_forward, 500);
-    m_descriptor_matcher->knnMatch(m_prev_descriptors, m_curr_descriptors, matches_backward, 500);
-
-    matches_good.reserve(matches_forward.size());
-    for (unsigned int i = 0; i < matches_forward.size(); ++i) {
-      for (unsigned int j = 0; j < matches_forward[i].size(); j++) {
-        cv::Point2f point_old = m_prev_key_points[matches_forward[i][j].queryIdx].pt;
-        cv::Point2f point_new = m_curr_key_points[matches_forward[i][j].trainIdx].pt;
-
-        // Calculate local distance for each possible match
-        double dist = sqrt(
-          (point_old.x - point_new.x) * (point_old.x - point_new.x) +
-          (point_old.y - point_new.y) * (point_old.y - point_new.y));
-
-        // Save as best match if local distance is in specified area and on same height
-        if (dist < threshold_dist) {
-          cv::line(img_out, point_old, point_new, cv::Scalar(0, 255, 0), 2, 8, 0);
-          matches_good.push_back(matches_forward[i][j]);
-          j = matches_forward[i].size();
-        }
-      }
+  std::vector<cv::DMatch> matches_good =
+    MatchPredictedWindows(predicted_points, threshold_dist, img.rows, img.cols);
+  m_tracked_count = matches_good.size();
+  if (m_draw_output) {
+    for (const auto & match : matches_good) {
+      cv::Point2f point_old = m_prev_key_points[match.queryIdx].pt;
+      cv::Point2f point_new = m_curr_key_points[match.trainIdx].pt;
+      cv::line(img_out, point_old, point_new, cv::Scalar(0, 255, 0), 2, 8, 0);
     }
+  }
 
-    /// @todo(jhartzer): Ratio and Symmetry testing?
+  // Assign previous Key Point ID for each match
+  for (const auto & m : matches_good) {
+    m_curr_key_points[m.trainIdx].class_id = m_prev_key_points[m.queryIdx].class_id;
+  }
 
-    // Assign previous Key Point ID for each match
-    for (const auto & m : matches_good) {
-      m_curr_key_points[m.trainIdx].class_id = m_prev_key_points[m.queryIdx].class_id;
+  // Only generate feature IDs for unmatched features
+  for (auto & key_point : m_curr_key_points) {
+    if (key_point.class_id == -1) {
+      key_point.class_id = GenerateFeatureID();
     }
+  }
 
-    // Only generate feature IDs for unmatched features
-    for (auto & key_point : m_curr_key_points) {
-      if (key_point.class_id == -1) {
-        key_point.class_id = GenerateFeatureID();
+  return true;
+}
+
+bool FeatureTracker::TrackOpticalFlow(
+  const std::vector<cv::Point2f> & predicted_points,
+  const cv::Mat & img,
+  cv::Mat & img_out)
+{
+  cv::Size window_size(m_klt_window_size, m_klt_window_size);
+  cv::buildOpticalFlowPyramid(img, m_curr_pyramid, window_size, m_klt_pyramid_levels);
+
+  std::vector<cv::KeyPoint> tracked_key_points;
+  std::vector<cv::Point2f> tracked_prev_points;
+  if (!m_prev_pyramid.empty() && !m_prev_key_points.empty()) {
+    std::vector<cv::Point2f> prev_points, curr_points, back_points;
+    std::vector<uchar> status_forward, status_backward;
+    std::vector<float> error;
+    cv::KeyPoint::convert(m_prev_key_points, prev_points);
+    curr_points = predicted_points;
+
+    // Forward-backward consistency check of the pyramidal Lucas-Kanade flow
+    cv::calcOpticalFlowPyrLK(
+      m_prev_pyramid, m_curr_pyramid, prev_points, curr_points, status_forward, error,
+      window_size, m_klt_pyramid_levels,
+      cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 30, 0.01),
+      cv::OPTFLOW_USE_INITIAL_FLOW);
+    cv::calcOpticalFlowPyrLK(
+      m_curr_pyramid, m_prev_pyramid, curr_points, back_points, status_backward, error,
+      window_size, m_klt_pyramid_levels);
+
+    for (unsigned int i = 0; i < prev_points.size(); ++i) {
+      cv::Point2f point_new = curr_points[i];
+      if (!status_forward[i] || !status_backward[i] ||
+        cv::norm(back_points[i] - prev_points[i]) > m_klt_max_error ||
+        point_new.x < 0 || point_new.y < 0 ||
+        point_new.x >= img.cols || point_new.y >= img.rows)
+      {
+        continue;
       }
+      cv::KeyPoint key_point = m_prev_key_points[i];
+      key_point.pt = point_new;
+      tracked_key_points.push_back(key_point);
+      tracked_prev_points.push_back(prev_points[i]);
     }
+  }
+
+  // Detect only in cells not already covered by a tracked feature
+  cv::Mat mask(img.size(), CV_8UC1, cv::Scalar(255));
+  for (const auto & key_point : tracked_key_points) {
+    cv::circle(mask, key_point.pt, m_nms_cell_size, cv::Scalar(0), cv::FILLED);
+  }
+  std::vector<cv::KeyPoint> new_key_points;
+  m_feature_detector->detect(img, new_key_points, mask);
+  BucketFeatures(new_key_points, img.rows, img.cols);
+  int new_budget = static_cast<int>(m_feature_budget) - static_cast<int>(tracked_key_points.size());
+  cv::KeyPointsFilter::retainBest(new_key_points, std::max(new_budget, 0));
+  m_tracked_count = tracked_key_points.size();
+  for (auto & key_point : new_key_points) {
+    key_point.class_id = GenerateFeatureID();
+  }
+
+  m_curr_key_points = tracked_key_points;
+  m_curr_key_points.insert(m_curr_key_points.end(), new_key_points.begin(), new_key_points.end());
+
+  if (m_draw_output) {
+    cv::drawKeypoints(img, m_curr_key_points, img_out);
+    for (unsigned int i = 0; i < tracked_prev_points.size(); ++i) {
+      cv::line(
+        img_out, tracked_prev_points[i], tracked_key_points[i].pt, cv::Scalar(0, 255, 0), 2, 8, 0);
+    }
+  }
 
-    // Store feature tracks
+  // Keep the pyramid buffers of both frames for reuse
+  m_prev_pyramid.swap(m_curr_pyramid);
+
+  return true;
+}
+
+void FeatureTracker::DetectTracks(
+  double time,
+  int frame_id,
+  cv::Mat & img_in,
+  cv::Mat & img_out,
+  const Eigen::Vector3d & body_ang_vel,
+  const Eigen::Quaterniond & ang_c_to_b,
+  FeatureTracks & feature_tracks)
+{
+  auto t_start = std::chrono::steady_clock::now();
+  m_tracked_count = 0U;
+
+  cv::Mat img = PreprocessImage(img_in);
+
+  m_logger->Log(LogLevel::DEBUG, "Called Tracker for frame ID: " + std::to_string(frame_id));
+
+  std::vector<cv::Point2f> predicted_points = PredictKeyPoints(time, body_ang_vel, ang_c_to_b);
+
+  bool is_tracked {false};
+  if (m_tracking_mode == TrackingModeEnum::KLT) {
+    is_tracked = TrackOpticalFlow(predicted_points, img, img_out);
+  } else {
+    is_tracked = TrackDescriptors(predicted_points, img, img_out);
+  }
+
+  if (is_tracked) {
+    // Store observations in input frame pixels, where the intrinsics apply
     for (const auto & key_point : m_curr_key_points) {
-      auto feature_track = FeaturePoint{frame_id, key_point};
-      m_feature_track_map[key_point.class_id].push_back(feature_track);
+      cv::Point2f input_point = ToInputPoint(key_point.pt);
+      m_track_table.Append(key_point.class_id, frame_id, input_point.x, input_point.y);
     }
 
     // Update MSCKF on features no longer detected
-    for (auto it = m_feature_track_map.cbegin(); it != m_feature_track_map.cend(); ) {
-      const auto & feature_track = it->second;
-      if ((feature_track.back().frame_id < frame_id) ||
-        (feature_track.size() >= m_max_track_length))
-      {
-        // This feature does not exist in the latest frame
-        if (feature_track.size() >= m_min_track_length) {
-          feature_tracks.push_back(feature_track);
-        }
-        it = m_feature_track_map.erase(it);
+    m_complete_feature_ids.clear();
+    m_track_table.FindComplete(frame_id, m_max_track_length, m_complete_feature_ids);
+    for (int feature_id : m_complete_feature_ids) {
+      if (m_track_table.GetTrackLength(feature_id) >= m_min_track_length) {
+        feature_tracks.push_back(AcquireTrack());
+        m_track_table.PopTrack(feature_id, feature_tracks.back());
       } else {
-        ++it;
+        m_track_table.Erase(feature_id);
       }
     }
   }
 
-  m_msckf_updater.UpdateEKF(m_ekf, time, feature_tracks, m_px_error);
-
   m_prev_key_points = m_curr_key_points;
-  m_prev_descriptors = m_curr_descriptors;
+
+  // Swap rather than share, so the next frame's descriptors do not overwrite these in place
+  std::swap(m_prev_descriptors, m_curr_descriptors);
+  m_prev_time = time;
+
+  // Frame latency includes the most recent filter update of this tracker
+  auto t_end = std::chrono::steady_clock::now();
+  double update_time = m_update_duration;
+  double frame_time = std::chrono::duration<double>(t_end - t_start).count() + update_time;
+  AdaptFeatureBudget(frame_time, m_tracked_count);
+
+  if (m_budget_logger.IsLogDue(time)) {
+    DataRecord & record = m_budget_logger.NewRecord();
+    record.Append(time).Append(frame_time).Append(update_time);
+    record.Append(m_curr_key_points.size()).Append(m_tracked_count).Append(m_feature_budget);
+    record.Append(m_detector_threshold);
+    m_budget_logger.LogRecord();
+  }
+}
+
+void FeatureTracker::UpdateTracks(double time, FeatureTracks & feature_tracks, bool predict)
+{
+  auto t_start = std::chrono::steady_clock::now();
+  if (m_feature_associator) {
+    m_feature_associator->Associate(m_camera_id, time, feature_tracks);
+  }
+  m_msckf_updater.UpdateEKF(m_ekf, time, feature_tracks, m_px_error, predict);
+  auto t_end = std::chrono::steady_clock::now();
+  m_update_duration = std::chrono::duration<double>(t_end - t_start).count();
+
+  // Recycle storage of consumed tracks
+  for (auto & feature_track : feature_tracks) {
+    ReleaseTrack(feature_track);
+  }
+  feature_tracks.clear();
+}
+
+void FeatureTracker::Track(double time, int frame_id, cv::Mat & img_in, cv::Mat & img_out)
+{
+  DetectTracks(
+    time, frame_id, img_in, img_out,
+    m_ekf->GetBodyState().m_angular_velocity,
+    m_ekf->GetCamState(m_camera_id).ang_c_to_b,
+    m_feature_tracks);
+  UpdateTracks(time, m_feature_tracks);
 }
 
 
 unsigned int FeatureTracker::GenerateFeatureID()
 {
-  static unsigned int featureID = 0;
-  return featureID++;
+  // Trackers detect on several worker threads and must never share a feature ID
+  static std::atomic<unsigned int> featureID {0U};
+  return featureID.fetch_add(1U, std::memory_order_relaxed);
+}
+
+std::vector<FeaturePoint> FeatureTracker::AcquireTrack()
+{
+  std::lock_guard<std::mutex> lock(m_track_pool_mutex);
+  std::vector<FeaturePoint> feature_track;
+  if (!m_track_pool.empty()) {
+    feature_track = std::move(m_track_pool.back());
+    m_track_pool.pop_back();
+  } else {
+    feature_track.reserve(m_max_track_length);
+  }
+  return feature_track;
+}
+
+void FeatureTracker::ReleaseTrack(std::vector<FeaturePoint> & feature_track)
+{
+  feature_track.clear();
+  std::lock_guard<std::mutex> lock(m_track_pool_mutex);
+  m_track_pool.push_back(std::move(feature_track));
 }
 
 unsigned int FeatureTracker::GetID()
@@ -16,8 +16,11 @@
 #ifndef TRACKERS__FEATURE_TRACKER_HPP_
 #define TRACKERS__FEATURE_TRACKER_HPP_
 
-#include <map>
+#include <eigen3/Eigen/Eigen>
+
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -27,8 +30,11 @@
 #include "ekf/ekf.hpp"
 #include "ekf/types.hpp"
 #include "ekf/update/msckf_updater.hpp"
+#include "infrastructure/data_logger.hpp"
 #include "infrastructure/debug_logger.hpp"
 #include "sensors/types.hpp"
+#include "trackers/feature_associator.hpp"
+#include "trackers/feature_track_table.hpp"
 
 ///
 /// @class FeatureTracker
@@ -68,6 +74,15 @@ public:
     FLANN
   };
 
+  ///
+  /// @brief Tracking Mode Enumerations
+  ///
+  enum class TrackingModeEnum
+  {
+    DESCRIPTOR,
+    KLT
+  };
+
   ///
   /// @brief Feature Tracker Initialization parameters structure
   ///
@@ -76,8 +91,24 @@ public:
     std::string name {""};                                          ///< @brief Feature Tracker name
     FeatureDetectorEnum detector {FeatureDetectorEnum::ORB};            ///< @brief Detector
     DescriptorExtractorEnum descriptor {DescriptorExtractorEnum::ORB};  ///< @brief Descriptor
-    DescriptorMatcherEnum matcher {DescriptorMatcherEnum::FLANN};       ///< @brief Matcher
+    DescriptorMatcherEnum matcher {DescriptorMatcherEnum::FLANN};       ///< @brief Matcher (unused)
     double threshold {20.0};                                            ///< @brief Threshold
+    TrackingModeEnum tracking_mode {TrackingModeEnum::DESCRIPTOR};      ///< @brief Tracking mode
+    unsigned int klt_window_size {21U};   ///< @brief Optical flow search window size
+    unsigned int klt_pyramid_levels {3U};  ///< @brief Optical flow pyramid levels
+    double klt_max_error {1.0};           ///< @brief Forward-backward optical flow error limit
+    bool gyro_prediction {true};          ///< @brief Predict key points from gyro rotation
+    bool mutual_check {true};             ///< @brief Require symmetric descriptor matches
+    double ratio_test {0.8};              ///< @brief Lowe ratio test threshold. Zero disables
+    unsigned int nms_cell_size {10U};     ///< @brief Suppression grid cell size in pixels
+    unsigned int nms_cell_quota {1U};     ///< @brief Key points kept per suppression cell
+    unsigned int image_width {640U};      ///< @brief Tracking image width. Zero disables resize
+    unsigned int image_height {480U};     ///< @brief Tracking image height. Zero disables resize
+    cv::Rect roi {0, 0, 0, 0};            ///< @brief Input crop region. Empty uses full frame
+    unsigned int max_features {1000U};    ///< @brief Initial and maximum features per frame
+    unsigned int min_features {50U};      ///< @brief Minimum features per frame
+    double target_frame_time {0.0};       ///< @brief Target frame latency. Zero disables budget
+    unsigned int target_track_count {0U};  ///< @brief Tracked features at which budget stops growing
     int sensor_id{-1};                    ///< @brief Associated sensor ID
     std::string output_directory {""};    ///< @brief Feature Tracker data logging directory
     bool data_logging_on {false};         ///< @brief Feature Tracker data logging flag
@@ -87,6 +118,12 @@ public:
     unsigned int max_track_length{20U};   ///< @brief Maximum track length before forced output
     double data_log_rate {0.0};           ///< @brief Data logging rate
     double min_feat_dist {1.0};           ///< @brief Minimum feature distance to consider
+    bool batch_triangulation {true};      ///< @brief Triangulate all tracks of an update at once
+    MsckfUpdater::TriangulationMethod triangulation_method {
+      MsckfUpdater::TriangulationMethod::LINEAR};  ///< @brief Feature triangulation method
+    unsigned int max_update_rows {0U};    ///< @brief Maximum MSCKF measurement rows per update
+    double max_update_time {0.0};         ///< @brief Target MSCKF update duration in seconds
+    bool chi_squared_gating {true};       ///< @brief Chi-squared measurement gating
     std::shared_ptr<DebugLogger> logger;  ///< @brief Debug logger
     std::shared_ptr<EKF> ekf;             ///< @brief EKF to update
   } Parameters;
@@ -98,17 +135,141 @@ public:
   explicit FeatureTracker(FeatureTracker::Parameters params);
 
   ///
-  /// @brief Down sample features to grid
-  /// @param key_points Key points to down sample
-  /// @param rows Number of final rows to consider
-  /// @param cols Number of final columns to consider
-  /// @return Down sampled key points
+  /// @brief Bucketed non-maximal suppression keeping the strongest key points of each grid cell
+  /// @param key_points Key points to suppress in place
+  /// @param rows Number of image rows to consider
+  /// @param cols Number of image columns to consider
   ///
-  std::vector<cv::KeyPoint> GridFeatures(
-    std::vector<cv::KeyPoint> key_points,
+  void BucketFeatures(
+    std::vector<cv::KeyPoint> & key_points,
     unsigned int rows,
     unsigned int cols);
 
+  ///
+  /// @brief Crop, convert to grayscale, and resize an input frame for tracking
+  /// @param img_in Input frame
+  /// @return Preprocessed grayscale frame, sharing the input buffer when no work is needed
+  ///
+  cv::Mat PreprocessImage(const cv::Mat & img_in);
+
+  ///
+  /// @brief Enable or disable drawing of the output track image
+  /// @param draw_output Output image drawing flag
+  ///
+  void SetDrawOutput(bool draw_output);
+
+  ///
+  /// @brief Share completed tracks with overlapping cameras before the MSCKF update
+  /// @param feature_associator Cross-camera feature associator. Null disables association
+  ///
+  void SetFeatureAssociator(std::shared_ptr<FeatureAssociator> feature_associator);
+
+  ///
+  /// @brief Adapt the per-frame feature budget and detector threshold to the measured latency
+  /// @param frame_time Measured detect, describe, match, and update time in seconds
+  /// @param tracked_count Number of features tracked from the previous frame
+  ///
+  void AdaptFeatureBudget(double frame_time, unsigned int tracked_count);
+
+  ///
+  /// @brief Feature budget getter method
+  /// @return Current maximum number of features per frame
+  ///
+  unsigned int GetFeatureBudget();
+
+  ///
+  /// @brief Predict previous key point locations in the next frame using body angular rate
+  /// @param time Next frame time
+  /// @return Predicted key point locations
+  ///
+  std::vector<cv::Point2f> PredictKeyPoints(double time);
+
+  ///
+  /// @brief Predict previous key point locations in the next frame using a given angular rate
+  /// @param time Next frame time
+  /// @param body_ang_vel Body angular velocity
+  /// @param ang_c_to_b Camera to body rotation
+  /// @return Predicted key point locations
+  ///
+  std::vector<cv::Point2f> PredictKeyPoints(
+    double time,
+    const Eigen::Vector3d & body_ang_vel,
+    const Eigen::Quaterniond & ang_c_to_b);
+
+  ///
+  /// @brief Distance between a previous and a current descriptor in the extractor's native norm
+  /// @param prev_index Previous descriptor row
+  /// @param curr_index Current descriptor row
+  /// @return Descriptor distance
+  ///
+  float DescriptorDistance(unsigned int prev_index, unsigned int curr_index);
+
+  ///
+  /// @brief Mutually match descriptors to key points within predicted search windows
+  /// @param predicted_points Predicted locations of previous key points
+  /// @param search_radius Search window radius in pixels
+  /// @param rows Image rows
+  /// @param cols Image columns
+  /// @return Best descriptor match for each previous key point with a candidate
+  ///
+  std::vector<cv::DMatch> MatchPredictedWindows(
+    const std::vector<cv::Point2f> & predicted_points,
+    double search_radius,
+    unsigned int rows,
+    unsigned int cols);
+
+  ///
+  /// @brief Detect, describe, and match key points against the previous frame
+  /// @param predicted_points Predicted locations of previous key points
+  /// @param img Input frame
+  /// @param img_out Output frame with drawn track lines
+  /// @return True if key points were matched to a previous frame
+  ///
+  bool TrackDescriptors(
+    const std::vector<cv::Point2f> & predicted_points,
+    const cv::Mat & img,
+    cv::Mat & img_out);
+
+  ///
+  /// @brief Propagate key points with optical flow and replenish empty regions
+  /// @param predicted_points Predicted locations of previous key points
+  /// @param img Input frame
+  /// @param img_out Output frame with drawn track lines
+  /// @return True if key points were tracked
+  ///
+  bool TrackOpticalFlow(
+    const std::vector<cv::Point2f> & predicted_points,
+    const cv::Mat & img,
+    cv::Mat & img_out);
+
+  ///
+  /// @brief Image tracking stage producing completed feature tracks without updating the EKF
+  /// @param time Frame time
+  /// @param frame_id Frame ID
+  /// @param img_in Input frame
+  /// @param img_out Output frame with drawn track lines
+  /// @param body_ang_vel Body angular velocity at frame time used for key point prediction
+  /// @param ang_c_to_b Camera to body rotation used for key point prediction
+  /// @param feature_tracks Output completed feature tracks
+  ///
+  void DetectTracks(
+    double time,
+    int frame_id,
+    cv::Mat & img_in,
+    cv::Mat & img_out,
+    const Eigen::Vector3d & body_ang_vel,
+    const Eigen::Quaterniond & ang_c_to_b,
+    FeatureTracks & feature_tracks);
+
+  ///
+  /// @brief Filter stage applying completed feature tracks to the EKF and recycling their storage
+  /// @param time Frame time of the feature tracks
+  /// @param feature_tracks Completed feature tracks, cleared on return
+  /// @param predict Predict the EKF to the frame time. Deferred updates arrive after the EKF
+  /// has advanced past their frame and skip the prediction
+  ///
+  void UpdateTracks(double time, FeatureTracks & feature_tracks, bool predict = true);
+
   ///
   /// @brief Perform track on new image frame
   /// @param time Frame time
@@ -132,6 +293,7 @@ protected:
   unsigned int m_id;                      ///< @brief Tracker ID
   std::shared_ptr<EKF> m_ekf;             ///< @brief EKF
   std::shared_ptr<DebugLogger> m_logger;  ///< @brief Debug logger
+  std::shared_ptr<FeatureAssociator> m_feature_associator;  ///< @brief Cross-camera associator
 
 private:
   cv::Ptr<cv::FeatureDetector> InitFeatureDetector(
@@ -140,21 +302,64 @@ private:
   cv::Ptr<cv::DescriptorExtractor> InitDescriptorExtractor(
     DescriptorExtractorEnum extractor,
     double threshold);
-  cv::Ptr<cv::DescriptorMatcher> InitDescriptorMatcher(
-    DescriptorMatcherEnum matcher);
 
   cv::Ptr<cv::FeatureDetector> m_feature_detector;
   cv::Ptr<cv::DescriptorExtractor> m_descriptor_extractor;
-  cv::Ptr<cv::DescriptorMatcher> m_descriptor_matcher;
 
   std::vector<cv::KeyPoint> m_prev_key_points;
   std::vector<cv::KeyPoint> m_curr_key_points;
   cv::Mat m_prev_descriptors;
   cv::Mat m_curr_descriptors;
+  std::vector<cv::Mat> m_prev_pyramid;
+  std::vector<cv::Mat> m_curr_pyramid;
+  unsigned int m_image_width {640U};
+  unsigned int m_image_height {480U};
+  cv::Rect m_roi;
+  cv::Point2f m_roi_offset;
+  double m_scale_x {1.0};
+  double m_scale_y {1.0};
+  cv::Mat m_gray_buffer;
+  cv::Mat m_resize_buffer;
+  std::atomic<bool> m_draw_output {true};
+  unsigned int m_feature_budget {1000U};
+  unsigned int m_max_features {1000U};
+  unsigned int m_min_features {50U};
+  double m_target_frame_time {0.0};
+  unsigned int m_target_track_count {0U};
+  unsigned int m_tracked_count {0U};
+  double m_detector_threshold {20.0};
+  double m_max_detector_threshold {20.0};
+  std::atomic<double> m_update_duration {0.0};
+  DataLogger m_budget_logger;
+  std::vector<std::vector<unsigned int>> m_match_grid;
+  int m_descriptor_norm {cv::NORM_L2};
+  double m_prev_time {-1.0};
+  bool m_gyro_prediction {true};
+  bool m_mutual_check {true};
+  double m_ratio_test {0.8};
+  unsigned int m_nms_cell_size {10U};
+  unsigned int m_nms_cell_quota {1U};
+  std::vector<unsigned int> m_bucket_cells;
+  std::vector<unsigned int> m_bucket_order;
+  std::vector<cv::KeyPoint> m_bucket_key_points;
+  Intrinsics m_intrinsics;
+
+  TrackingModeEnum m_tracking_mode {TrackingModeEnum::DESCRIPTOR};
+  unsigned int m_klt_window_size {21U};
+  unsigned int m_klt_pyramid_levels {3U};
+  double m_klt_max_error {1.0};
 
-  std::map<unsigned int, std::vector<FeaturePoint>> m_feature_track_map;
+  FeatureTrackTable m_track_table;
+  std::vector<int> m_complete_feature_ids;
+  FeatureTracks m_feature_tracks;
+  FeatureTracks m_track_pool;
+  std::mutex m_track_pool_mutex;
 
   unsigned int GenerateFeatureID();
+  cv::Point2f ToInputPoint(const cv::Point2f & point);
+  cv::Point2f ToImagePoint(const cv::Point2f & point);
+  std::vector<FeaturePoint> AcquireTrack();
+  void ReleaseTrack(std::vector<FeaturePoint> & feature_track);
 
 
   double m_px_error;
@@ -15,6 +15,15 @@
 
 #include "trackers/fiducial_tracker.hpp"
 
+#include <eigen3/Eigen/Eigen>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <opencv2/aruco.hpp>
 #include <opencv2/aruco/charuco.hpp>
 
 FiducialTracker::FiducialTracker(FiducialTracker::Parameters params)
@@ -36,6 +45,126 @@ FiducialTracker::FiducialTracker(FiducialTracker::Parameters params)
   m_max_track_length = params.max_track_length;
   m_pos_error = params.variance.segment<3>(0);
   m_ang_error = params.variance.segment<3>(3);
+  m_fiducial_updater.SetChiSquaredGating(params.chi_squared_gating);
+
+  // Detector objects are built once and reused for every frame
+  m_dictionary = cv::aruco::getPredefinedDictionary(params.predefined_dictionary);
+  m_detector_params = cv::aruco::DetectorParameters::create();
+  m_detector_params->cornerRefinementMethod = params.corner_refinement;
+  m_detector_params->adaptiveThreshWinSizeMin = params.adaptive_thresh_win_size_min;
+  m_detector_params->adaptiveThreshWinSizeMax = params.adaptive_thresh_win_size_max;
+  m_detector_params->adaptiveThreshWinSizeStep = params.adaptive_thresh_win_size_step;
+  m_detector_params->minMarkerPerimeterRate = params.min_marker_perimeter_rate;
+
+  // Boards share one geometry and are told apart by their marker IDs
+  std::vector<BoardParameters> boards;
+  boards.push_back({params.pos_f_in_g, params.ang_f_to_g, params.initial_id});
+  boards.insert(boards.end(), params.boards.begin(), params.boards.end());
+  m_board_count = boards.size();
+
+  if ((params.squares_x > 1) && (params.squares_y > 1) && (params.marker_length > 0.0) &&
+    (params.square_length > params.marker_length))
+  {
+    for (auto const & board_params : boards) {
+      cv::Ptr<cv::aruco::CharucoBoard> board = cv::aruco::CharucoBoard::create(
+        params.squares_x, params.squares_y,
+        static_cast<float>(params.square_length), static_cast<float>(params.marker_length),
+        m_dictionary);
+      for (auto & marker_id : board->ids) {
+        marker_id += board_params.initial_id;
+      }
+      m_boards.push_back(board);
+    }
+  } else if (m_logger) {
+    m_logger->Log(LogLevel::WARN, "Invalid board geometry for fiducial: " + params.name);
+  }
+
+  for (unsigned int board_id = 0; board_id < m_board_count; ++board_id) {
+    m_pos_f_in_g[board_id] = boards[board_id].pos_f_in_g;
+    m_ang_f_to_g[board_id] = boards[board_id].ang_f_to_g;
+    m_fiducial_updater.SetBoardPose(
+      board_id, boards[board_id].pos_f_in_g, boards[board_id].ang_f_to_g);
+  }
+
+  m_camera_matrix = (cv::Mat_<double>(3, 3) <<
+    m_intrinsics.f_x, 0.0, m_intrinsics.c_x,
+    0.0, m_intrinsics.f_y, m_intrinsics.c_y,
+    0.0, 0.0, 1.0);
+  m_dist_coeffs = (cv::Mat_<double>(4, 1) <<
+    m_intrinsics.k_1, m_intrinsics.k_2, m_intrinsics.p_1, m_intrinsics.p_2);
+
+  m_board_size(0) = params.squares_x * params.square_length;
+  m_board_size(1) = params.squares_y * params.square_length;
+  m_predict_roi = params.predict_roi;
+  m_roi_padding = params.roi_padding;
+  m_full_search_interval = params.full_search_interval;
+}
+
+cv::Rect FiducialTracker::PredictBoardROI(const cv::Size & image_size)
+{
+  BodyState body_state = m_ekf->GetBodyState();
+  CamState cam_state = m_ekf->GetCamState(m_camera_id);
+  Eigen::Quaterniond ang_c_to_g = body_state.m_ang_b_to_g * cam_state.ang_c_to_b;
+  Eigen::Vector3d pos_c_in_g =
+    body_state.m_ang_b_to_g * cam_state.pos_c_in_b + body_state.m_position;
+
+  // Project the board corners through the current camera pose estimate
+  double roi_min_x {std::numeric_limits<double>::max()};
+  double roi_min_y {std::numeric_limits<double>::max()};
+  double roi_max_x {std::numeric_limits<double>::lowest()};
+  double roi_max_y {std::numeric_limits<double>::lowest()};
+  for (unsigned int board_id = 0; board_id < m_board_count; ++board_id) {
+    double min_x {std::numeric_limits<double>::max()};
+    double min_y {std::numeric_limits<double>::max()};
+    double max_x {std::numeric_limits<double>::lowest()};
+    double max_y {std::numeric_limits<double>::lowest()};
+    bool in_front {true};
+    for (double corner_x : {0.0, m_board_size(0)}) {
+      for (double corner_y : {0.0, m_board_size(1)}) {
+        Eigen::Vector3d pos_corner_in_g = m_ang_f_to_g[board_id] *
+          Eigen::Vector3d(corner_x, corner_y, 0.0) + m_pos_f_in_g[board_id];
+        Eigen::Vector3d pos_corner_in_c = ang_c_to_g.inverse() * (pos_corner_in_g - pos_c_in_g);
+        if (pos_corner_in_c(2) <= 0.0) {
+          in_front = false;
+          break;
+        }
+        double u = m_intrinsics.f_x * pos_corner_in_c(0) / pos_corner_in_c(2) + m_intrinsics.c_x;
+        double v = m_intrinsics.f_y * pos_corner_in_c(1) / pos_corner_in_c(2) + m_intrinsics.c_y;
+        min_x = std::min(min_x, u);
+        min_y = std::min(min_y, v);
+        max_x = std::max(max_x, u);
+        max_y = std::max(max_y, v);
+      }
+      if (!in_front) {
+        break;
+      }
+    }
+    if (!in_front) {
+      continue;
+    }
+
+    // Padding absorbs state error and lens distortion
+    double padding = m_roi_padding * std::max(max_x - min_x, max_y - min_y);
+    roi_min_x = std::min(roi_min_x, min_x - padding);
+    roi_min_y = std::min(roi_min_y, min_y - padding);
+    roi_max_x = std::max(roi_max_x, max_x + padding);
+    roi_max_y = std::max(roi_max_y, max_y + padding);
+  }
+
+  double min_x = std::max(roi_min_x, 0.0);
+  double min_y = std::max(roi_min_y, 0.0);
+  double max_x = std::min(roi_max_x, static_cast<double>(image_size.width));
+  double max_y = std::min(roi_max_y, static_cast<double>(image_size.height));
+  if ((max_x <= min_x) || (max_y <= min_y)) {
+    return cv::Rect();
+  }
+
+  int roi_x = static_cast<int>(std::floor(min_x));
+  int roi_y = static_cast<int>(std::floor(min_y));
+  return cv::Rect(
+    roi_x, roi_y,
+    static_cast<int>(std::ceil(max_x)) - roi_x,
+    static_cast<int>(std::ceil(max_y)) - roi_y);
 }
 
 void FiducialTracker::Track(
@@ -44,69 +173,107 @@ void FiducialTracker::Track(
   cv::Mat & img_in,
   cv::Mat & img_out)
 {
-  const cv::Ptr<cv::aruco::Dictionary> dictionary =
-    cv::aruco::getPredefinedDictionary(cv::aruco::DICT_6X6_250);
-  cv::Ptr<cv::aruco::CharucoBoard> board =
-    cv::aruco::CharucoBoard::create(5, 7, 0.04f, 0.02f, dictionary);
-  cv::Ptr<cv::aruco::DetectorParameters> params = cv::makePtr<cv::aruco::DetectorParameters>();
+  if (m_boards.empty()) {
+    return;
+  }
+
+  // Search the predicted board region, with a full-frame search periodically and after a miss
+  cv::Rect roi(0, 0, img_in.cols, img_in.rows);
+  bool full_search = !m_predict_roi || !m_board_detected ||
+    (m_frames_since_search >= m_full_search_interval);
+  if (!full_search) {
+    cv::Rect predicted_roi = PredictBoardROI(img_in.size());
+    if (predicted_roi.empty()) {
+      full_search = true;
+    } else {
+      roi = predicted_roi;
+    }
+  }
+  if (full_search) {
+    m_frames_since_search = 0U;
+  } else {
+    ++m_frames_since_search;
+  }
+
   std::vector<int> marker_ids;
-  cv::Mat camera_matrix, dist_coeff;
   std::vector<std::vector<cv::Point2f>> marker_corners;
-  cv::aruco::detectMarkers(img_in, dictionary, marker_corners, marker_ids, params);
-  bool detection_made {false};
+  cv::aruco::detectMarkers(
+    img_in(roi), m_dictionary, marker_corners, marker_ids, m_detector_params);
+  cv::Point2f roi_offset(static_cast<float>(roi.x), static_cast<float>(roi.y));
+  for (auto & corners : marker_corners) {
+    for (auto & corner : corners) {
+      corner += roi_offset;
+    }
+  }
+  m_board_detected = !marker_ids.empty();
 
-  // if at least one marker detected
+  // Every board is resolved from the same set of detected markers
+  bool flush_tracks {false};
   if (marker_ids.size() > 0) {
     cv::aruco::drawDetectedMarkers(img_out, marker_corners, marker_ids);
-    std::vector<cv::Point2f> charuco_corners;
-    std::vector<int> charuco_ids;
-    cv::aruco::interpolateCornersCharuco(
-      marker_corners, marker_ids, img_in, board, charuco_corners,
-      charuco_ids, camera_matrix, dist_coeff);
-
-    // if at least one charuco corner detected
-    if (charuco_ids.size() > 0) {
-      cv::Scalar color = cv::Scalar(255, 0, 0);
-      cv::aruco::drawDetectedCornersCharuco(img_out, charuco_corners, charuco_ids, color);
-      cv::Vec3d r_vec, t_vec;
-      bool valid = cv::aruco::estimatePoseCharucoBoard(
-        charuco_corners, charuco_ids, board,
-        camera_matrix, dist_coeff, r_vec, t_vec);
-
-      // if charuco pose is valid
-      if (valid) {
-        cv::drawFrameAxes(img_out, camera_matrix, dist_coeff, r_vec, t_vec, 0.1f);
-      }
-      BoardDetection board_detection;
-      board_detection.frame_id = frame_id;
-      board_detection.t_vec_f_in_c = t_vec;
-      board_detection.r_vec_f_to_c = r_vec;
-      m_board_track.push_back(board_detection);
-      detection_made = true;
-    }
   }
+  for (unsigned int board_id = 0; board_id < m_boards.size(); ++board_id) {
+    bool detection_made {false};
 
-  bool update_ekf {false};
-  if (detection_made) {
-    if (m_board_track.size() >= m_max_track_length) {
-      update_ekf = true;
+    // if at least one marker detected
+    if (marker_ids.size() > 0) {
+      std::vector<cv::Point2f> charuco_corners;
+      std::vector<int> charuco_ids;
+      cv::aruco::interpolateCornersCharuco(
+        marker_corners, marker_ids, img_in, m_boards[board_id], charuco_corners,
+        charuco_ids, m_camera_matrix, m_dist_coeffs);
+
+      // if at least one charuco corner detected
+      if (charuco_ids.size() > 0) {
+        cv::Scalar color = cv::Scalar(255, 0, 0);
+        cv::aruco::drawDetectedCornersCharuco(img_out, charuco_corners, charuco_ids, color);
+        cv::Vec3d r_vec, t_vec;
+        bool valid = cv::aruco::estimatePoseCharucoBoard(
+          charuco_corners, charuco_ids, m_boards[board_id],
+          m_camera_matrix, m_dist_coeffs, r_vec, t_vec);
+
+        // if charuco pose is valid
+        if (valid) {
+          cv::drawFrameAxes(img_out, m_camera_matrix, m_dist_coeffs, r_vec, t_vec, 0.1f);
+          BoardDetection board_detection;
+          board_detection.frame_id = frame_id;
+          board_detection.t_vec_f_in_c = t_vec;
+          board_detection.r_vec_f_to_c = r_vec;
+          board_detection.board_id = board_id;
+          m_board_tracks[board_id].push_back(board_detection);
+          detection_made = true;
+        }
+      }
     }
-  } else {
-    if (m_board_track.size() < m_min_track_length) {
-      m_board_track.clear();
-    } else {
-      update_ekf = true;
+
+    if (detection_made) {
+      if (m_board_tracks[board_id].size() >= m_max_track_length) {
+        flush_tracks = true;
+      }
+    } else if (m_board_tracks[board_id].size() < m_min_track_length) {
+      m_board_tracks[board_id].clear();
+    } else if (m_board_tracks[board_id].size() > 0) {
+      flush_tracks = true;
     }
   }
 
-  if (update_ekf) {
+  // Boards ready for an update are stacked together with every other usable board track
+  if (flush_tracks) {
+    std::vector<BoardTrack> board_tracks;
+    for (unsigned int board_id = 0; board_id < m_boards.size(); ++board_id) {
+      if ((m_board_tracks[board_id].size() > 0) &&
+        (m_board_tracks[board_id].size() >= m_min_track_length))
+      {
+        board_tracks.push_back(m_board_tracks[board_id]);
+        m_board_tracks[board_id].clear();
+      }
+    }
     m_fiducial_updater.UpdateEKF(
       m_ekf,
       time,
-      m_board_track,
+      board_tracks,
       m_pos_error.norm(),
       m_ang_error.norm());
-    m_board_track.clear();
   }
 }
 
@@ -114,3 +281,8 @@ unsigned int FiducialTracker::GetID()
 {
   return m_id;
 }
+
+cv::Ptr<cv::aruco::DetectorParameters> FiducialTracker::GetDetectorParameters()
+{
+  return m_detector_params;
+}
@@ -16,11 +16,15 @@
 #ifndef TRACKERS__FIDUCIAL_TRACKER_HPP_
 #define TRACKERS__FIDUCIAL_TRACKER_HPP_
 
+#include <eigen3/Eigen/Eigen>
+
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <opencv2/aruco.hpp>
+#include <opencv2/aruco/charuco.hpp>
 #include <opencv2/features2d.hpp>
 #include <opencv2/opencv.hpp>
 
@@ -47,6 +51,16 @@ public:
     APRIL_GRID,
   };
 
+  ///
+  /// @brief Additional board sharing the geometry and dictionary of the first board
+  ///
+  typedef struct BoardParameters
+  {
+    Eigen::Vector3d pos_f_in_g {0.0, 0.0, 0.0};          ///< @brief Board position
+    Eigen::Quaterniond ang_f_to_g {1.0, 0.0, 0.0, 0.0};  ///< @brief Board orientation
+    unsigned int initial_id {0U};                        ///< @brief Initial marker ID
+  } BoardParameters;
+
   ///
   /// @brief Feature Tracker Initialization parameters structure
   ///
@@ -56,7 +70,9 @@ public:
     int sensor_id{-1};                              ///< @brief Associated sensor ID
     std::string output_directory {""};              ///< @brief Feature Tracker data log directory
     bool data_logging_on {false};                   ///< @brief Feature Tracker data log flag
-    FiducialTypeEnum detector_type;                 ///< @brief Detector type
+    FiducialTypeEnum detector_type {FiducialTypeEnum::CHARUCO_BOARD};  ///< @brief Detector type
+    /// @brief ArUco marker dictionary
+    cv::aruco::PREDEFINED_DICTIONARY_NAME predefined_dictionary {cv::aruco::DICT_6X6_250};
     unsigned int squares_x {1U};                    ///< @brief Number of squares in the x direction
     unsigned int squares_y {1U};                    ///< @brief Number of squares in the y direction
     double square_length {1.0};                     ///< @brief Checkerboard square length
@@ -69,6 +85,17 @@ public:
     Eigen::Quaterniond ang_f_to_g;                  ///< @brief Fiducial orientation
     Eigen::VectorXd variance {{1, 1, 1, 1, 1, 1}};  ///< @brief Fiducial marker variance
     double data_log_rate {0.0};                     ///< @brief Data logging rate
+    bool chi_squared_gating {true};                 ///< @brief Chi-squared measurement gating
+    /// @brief Marker corner refinement method
+    cv::aruco::CornerRefineMethod corner_refinement {cv::aruco::CORNER_REFINE_NONE};
+    int adaptive_thresh_win_size_min {3};           ///< @brief Minimum threshold window size
+    int adaptive_thresh_win_size_max {23};          ///< @brief Maximum threshold window size
+    int adaptive_thresh_win_size_step {10};         ///< @brief Threshold window size step
+    double min_marker_perimeter_rate {0.03};        ///< @brief Minimum perimeter to image size
+    bool predict_roi {false};                       ///< @brief Detect in a predicted region
+    double roi_padding {0.25};                      ///< @brief ROI padding relative to board size
+    unsigned int full_search_interval {10U};        ///< @brief Frames between full-frame searches
+    std::vector<BoardParameters> boards;            ///< @brief Additional boards in the same pass
     std::shared_ptr<DebugLogger> logger;            ///< @brief Debug logger
     std::shared_ptr<EKF> ekf;                       ///< @brief EKF to update
   } Parameters;
@@ -94,6 +121,19 @@ public:
   ///
   unsigned int GetID();
 
+  ///
+  /// @brief Marker detector parameters getter method
+  /// @return Detector parameters used for every frame, which may be tuned in place
+  ///
+  cv::Ptr<cv::aruco::DetectorParameters> GetDetectorParameters();
+
+  ///
+  /// @brief Predict the image region of the boards from the current state estimate
+  /// @param image_size Size of the input image
+  /// @return Padded bounding box of all boards in view clipped to the image. Empty if none are
+  ///
+  cv::Rect PredictBoardROI(const cv::Size & image_size);
+
 protected:
   unsigned int m_max_track_length{20U};   ///< @brief Maximum track length before forced output
   unsigned int m_min_track_length{2U};    ///< @brief Minimum track length to consider
@@ -102,11 +142,25 @@ protected:
   unsigned int m_id;                      ///< @brief Tracker ID
   Intrinsics m_intrinsics;                ///< @brief Camera intrinsics
   FiducialTypeEnum m_detector_type;       ///< @brief Detector type
+  unsigned int m_board_count {1U};        ///< @brief Number of boards detected per frame
   std::shared_ptr<EKF> m_ekf;             ///< @brief EKF
   std::shared_ptr<DebugLogger> m_logger;  ///< @brief Debug logger
 
 private:
-  BoardTrack m_board_track;
+  cv::Ptr<cv::aruco::Dictionary> m_dictionary;
+  std::vector<cv::Ptr<cv::aruco::CharucoBoard>> m_boards;
+  cv::Ptr<cv::aruco::DetectorParameters> m_detector_params;
+  cv::Mat m_camera_matrix;
+  cv::Mat m_dist_coeffs;
+  std::map<unsigned int, Eigen::Vector3d> m_pos_f_in_g;
+  std::map<unsigned int, Eigen::Quaterniond> m_ang_f_to_g;
+  Eigen::Vector2d m_board_size {0.0, 0.0};
+  bool m_predict_roi {false};
+  double m_roi_padding {0.25};
+  unsigned int m_full_search_interval {10U};
+  unsigned int m_frames_since_search {0U};
+  bool m_board_detected {false};
+  std::map<unsigned int, BoardTrack> m_board_tracks;
   Eigen::Vector3d m_pos_error;
   Eigen::Vector3d m_ang_error;
 };
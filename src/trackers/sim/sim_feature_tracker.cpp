@@ -136,14 +136,14 @@ std::vector<std::shared_ptr<SimFeatureTrackerMessage>> SimFeatureTracker::Genera
     }
 
     // Update MSCKF on features no longer detected
-    for (auto it = feature_track_map.cbegin(); it != feature_track_map.cend(); ) {
-      const auto & feature_track = it->second;
+    for (auto it = feature_track_map.begin(); it != feature_track_map.end(); ) {
+      auto & feature_track = it->second;
       if ((feature_track.back().frame_id < frame_id) ||
         (feature_track.size() >= m_max_track_length))
       {
         // This feature does not exist in the latest frame
         if (feature_track.size() > 1) {
-          feature_tracks.push_back(feature_track);
+          feature_tracks.push_back(std::move(feature_track));
         }
         it = feature_track_map.erase(it);
       } else {
@@ -151,7 +151,7 @@ std::vector<std::shared_ptr<SimFeatureTrackerMessage>> SimFeatureTracker::Genera
       }
     }
     auto tracker_message = std::make_shared<SimFeatureTrackerMessage>();
-    tracker_message->m_feature_tracks = feature_tracks;
+    tracker_message->m_feature_tracks = std::move(feature_tracks);
     tracker_message->m_time = message_times[frame_id];
     tracker_message->m_tracker_id = m_id;
     tracker_message->m_sensor_id = sensor_id;
@@ -163,9 +163,11 @@ std::vector<std::shared_ptr<SimFeatureTrackerMessage>> SimFeatureTracker::Genera
 
 void SimFeatureTracker::Callback(double time, std::shared_ptr<SimFeatureTrackerMessage> msg)
 {
-  m_msckf_updater.UpdateEKF(
-    m_ekf,
-    time,
-    msg->m_feature_tracks,
-    m_px_error);
+  if (m_feature_associator) {
+    FeatureTracks feature_tracks = msg->m_feature_tracks;
+    m_feature_associator->Associate(m_camera_id, time, feature_tracks);
+    m_msckf_updater.UpdateEKF(m_ekf, time, feature_tracks, m_px_error);
+  } else {
+    m_msckf_updater.UpdateEKF(m_ekf, time, msg->m_feature_tracks, m_px_error);
+  }
 }
@@ -25,6 +25,7 @@ SimFiducialTracker::SimFiducialTracker(
 {
   m_no_errors = params.no_errors;
   m_truth = truthEngine;
+  m_truth_board_id = params.truth_board_id;
 
   m_pos_error = params.pos_error;
   m_ang_error = params.ang_error;
@@ -42,7 +43,7 @@ SimFiducialTracker::SimFiducialTracker(
   m_proj_matrix.at<double>(2, 2) = 1;
 }
 
-bool SimFiducialTracker::IsBoardVisible(double time, int sensor_id)
+bool SimFiducialTracker::IsBoardVisible(double time, int sensor_id, unsigned int board_id)
 {
   Eigen::Vector3d pos_b_in_g = m_truth->GetBodyPosition(time);
   Eigen::Quaterniond ang_b_to_g = m_truth->GetBodyAngularPosition(time);
@@ -75,7 +76,7 @@ bool SimFiducialTracker::IsBoardVisible(double time, int sensor_id)
   std::vector<cv::Point2d> projected_points;
   std::vector<cv::Point3d> board_position_vector;
   cv::Point3d board_position;
-  Eigen::Vector3d pos_f_in_g_true = m_truth->GetBoardPosition(0);
+  Eigen::Vector3d pos_f_in_g_true = m_truth->GetBoardPosition(m_truth_board_id + board_id);
   board_position.x = pos_f_in_g_true[0];
   board_position.y = pos_f_in_g_true[1];
   board_position.z = pos_f_in_g_true[2];
@@ -105,12 +106,9 @@ std::vector<std::shared_ptr<SimFiducialTrackerMessage>> SimFiducialTracker::Gene
     LogLevel::INFO, "Generating " + std::to_string(message_times.size()) + " measurements");
 
   std::vector<std::shared_ptr<SimFiducialTrackerMessage>> fiducial_tracker_messages;
-  Eigen::Vector3d pos_f_in_g_true = m_truth->GetBoardPosition(0);
-  Eigen::Quaterniond ang_f_to_g_true = m_truth->GetBoardOrientation(0);
 
-  BoardTrack board_track;
+  std::vector<BoardTrack> board_tracks(m_board_count);
   for (int frame_id = 0; static_cast<unsigned int>(frame_id) < message_times.size(); ++frame_id) {
-    std::vector<std::vector<FeaturePoint>> feature_tracks;
     auto tracker_message = std::make_shared<SimFiducialTrackerMessage>();
     tracker_message->m_time = message_times[frame_id];
     tracker_message->m_tracker_id = m_id;
@@ -119,41 +117,60 @@ std::vector<std::shared_ptr<SimFiducialTrackerMessage>> SimFiducialTracker::Gene
     tracker_message->m_pos_error = m_t_vec_error;
     tracker_message->m_ang_error = m_r_vec_error;
 
-    bool is_board_visible = IsBoardVisible(message_times[frame_id], sensor_id);
-    if (is_board_visible) {
-      Eigen::Vector3d pos_b_in_g = m_truth->GetBodyPosition(message_times[frame_id]);
-      Eigen::Quaterniond ang_b_to_g = m_truth->GetBodyAngularPosition(message_times[frame_id]);
-      Eigen::Vector3d pos_c_in_b_true = m_truth->GetCameraPosition(sensor_id);
-      Eigen::Quaterniond ang_c_to_b_true = m_truth->GetCameraAngularPosition(sensor_id);
-
-      Eigen::Matrix3d rot_g_to_b = ang_b_to_g.toRotationMatrix().transpose();
-      Eigen::Matrix3d rot_b_to_c = ang_c_to_b_true.toRotationMatrix().transpose();
-
-      Eigen::Vector3d pos_f_in_c_true =
-        rot_b_to_c * (rot_g_to_b * (pos_f_in_g_true - pos_b_in_g) - pos_c_in_b_true);
-
-      BoardDetection board_detection;
-      board_detection.frame_id = frame_id;
-      board_detection.t_vec_f_in_c[0] = m_rng.NormRand(pos_f_in_c_true[0], m_t_vec_error[0]);
-      board_detection.t_vec_f_in_c[1] = m_rng.NormRand(pos_f_in_c_true[1], m_t_vec_error[1]);
-      board_detection.t_vec_f_in_c[2] = m_rng.NormRand(pos_f_in_c_true[2], m_t_vec_error[2]);
-
-      Eigen::Vector3d ang_f_to_c_error_rpy;
-      ang_f_to_c_error_rpy(0) = m_rng.NormRand(0.0, m_r_vec_error[0]);
-      ang_f_to_c_error_rpy(1) = m_rng.NormRand(0.0, m_r_vec_error[1]);
-      ang_f_to_c_error_rpy(2) = m_rng.NormRand(0.0, m_r_vec_error[2]);
-      Eigen::Quaterniond ang_f_to_c = EigVecToQuat(ang_f_to_c_error_rpy) *
-        ang_c_to_b_true.inverse() * ang_b_to_g.inverse() * ang_f_to_g_true;
-      board_detection.r_vec_f_to_c = QuatToRodrigues(ang_f_to_c);
-
-      board_track.push_back(board_detection);
-    } else if (board_track.size() < m_min_track_length) {
-      board_track.clear();
+    bool flush_tracks {false};
+    for (unsigned int board_id = 0; board_id < m_board_count; ++board_id) {
+      BoardTrack & board_track = board_tracks[board_id];
+      bool is_board_visible = IsBoardVisible(message_times[frame_id], sensor_id, board_id);
+      if (is_board_visible) {
+        Eigen::Vector3d pos_f_in_g_true = m_truth->GetBoardPosition(m_truth_board_id + board_id);
+        Eigen::Quaterniond ang_f_to_g_true =
+          m_truth->GetBoardOrientation(m_truth_board_id + board_id);
+        Eigen::Vector3d pos_b_in_g = m_truth->GetBodyPosition(message_times[frame_id]);
+        Eigen::Quaterniond ang_b_to_g = m_truth->GetBodyAngularPosition(message_times[frame_id]);
+        Eigen::Vector3d pos_c_in_b_true = m_truth->GetCameraPosition(sensor_id);
+        Eigen::Quaterniond ang_c_to_b_true = m_truth->GetCameraAngularPosition(sensor_id);
+
+        Eigen::Matrix3d rot_g_to_b = ang_b_to_g.toRotationMatrix().transpose();
+        Eigen::Matrix3d rot_b_to_c = ang_c_to_b_true.toRotationMatrix().transpose();
+
+        Eigen::Vector3d pos_f_in_c_true =
+          rot_b_to_c * (rot_g_to_b * (pos_f_in_g_true - pos_b_in_g) - pos_c_in_b_true);
+
+        BoardDetection board_detection;
+        board_detection.frame_id = frame_id;
+        board_detection.board_id = board_id;
+        board_detection.t_vec_f_in_c[0] = m_rng.NormRand(pos_f_in_c_true[0], m_t_vec_error[0]);
+        board_detection.t_vec_f_in_c[1] = m_rng.NormRand(pos_f_in_c_true[1], m_t_vec_error[1]);
+        board_detection.t_vec_f_in_c[2] = m_rng.NormRand(pos_f_in_c_true[2], m_t_vec_error[2]);
+
+        Eigen::Vector3d ang_f_to_c_error_rpy;
+        ang_f_to_c_error_rpy(0) = m_rng.NormRand(0.0, m_r_vec_error[0]);
+        ang_f_to_c_error_rpy(1) = m_rng.NormRand(0.0, m_r_vec_error[1]);
+        ang_f_to_c_error_rpy(2) = m_rng.NormRand(0.0, m_r_vec_error[2]);
+        Eigen::Quaterniond ang_f_to_c = EigVecToQuat(ang_f_to_c_error_rpy) *
+          ang_c_to_b_true.inverse() * ang_b_to_g.inverse() * ang_f_to_g_true;
+        board_detection.r_vec_f_to_c = QuatToRodrigues(ang_f_to_c);
+
+        board_track.push_back(board_detection);
+      } else if (board_track.size() < m_min_track_length) {
+        board_track.clear();
+      }
+
+      if ((!is_board_visible && (board_track.size() > 0)) ||
+        (board_track.size() >= m_max_track_length))
+      {
+        flush_tracks = true;
+      }
     }
 
-    if (!is_board_visible || board_track.size() >= m_max_track_length) {
-      tracker_message->m_board_track = board_track;
-      board_track.clear();
+    // Tracks of all boards are sent together so they share a single update
+    if (flush_tracks) {
+      for (auto & board_track : board_tracks) {
+        if ((board_track.size() > 0) && (board_track.size() >= m_min_track_length)) {
+          tracker_message->m_board_tracks.push_back(board_track);
+          board_track.clear();
+        }
+      }
     }
 
     fiducial_tracker_messages.push_back(tracker_message);
@@ -166,7 +183,7 @@ void SimFiducialTracker::Callback(double time, std::shared_ptr<SimFiducialTracke
   m_fiducial_updater.UpdateEKF(
     m_ekf,
     time,
-    msg->m_board_track,
+    msg->m_board_tracks,
     msg->m_pos_error.norm(),
     msg->m_ang_error.norm());
 }
@@ -48,6 +48,7 @@ public:
     Eigen::Vector3d ang_error{1e-9, 1e-9, 1e-9};    ///< @brief Angular error standard deviation
     Eigen::Vector3d t_vec_error{1e-9, 1e-9, 1e-9};  ///< @brief t_vec error standard deviation
     Eigen::Vector3d r_vec_error{1e-9, 1e-9, 1e-9};  ///< @brief r_vec error standard deviation
+    unsigned int truth_board_id {0U};               ///< @brief Truth engine ID of the first board
     FiducialTracker::Parameters fiducial_params;    ///< @brief Tracker parameters
   } Parameters;
 
@@ -69,11 +70,12 @@ public:
     std::vector<double> message_times, int sensor_id);
 
   ///
-  /// @brief Return currently visible keypoints
+  /// @brief Check if a board is currently visible
   /// @param time Current time
   /// @param sensor_id Camera sensor ID
+  /// @param board_id Board ID within the tracker
   ///
-  bool IsBoardVisible(double time, int sensor_id);
+  bool IsBoardVisible(double time, int sensor_id, unsigned int board_id);
 
   ///
   /// @brief Callback for feature tracker
@@ -88,6 +90,7 @@ private:
   Eigen::Vector3d m_t_vec_error;
   Eigen::Vector3d m_r_vec_error;
   std::shared_ptr<TruthEngine> m_truth;
+  unsigned int m_truth_board_id {0U};
   bool m_no_errors {false};
   SimRNG m_rng;
 
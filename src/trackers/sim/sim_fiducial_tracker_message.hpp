@@ -18,6 +18,8 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include <vector>
+
 #include "ekf/types.hpp"
 #include "sensors/sensor_message.hpp"
 
@@ -30,7 +32,7 @@ class SimFiducialTrackerMessage : public SensorMessage
 public:
   SimFiducialTrackerMessage() {}
   unsigned int m_tracker_id {0};  ///< @brief Associated Tracker ID
-  BoardTrack m_board_track;       ///< @brief Board track
+  std::vector<BoardTrack> m_board_tracks;  ///< @brief Board tracks, one per board
   Eigen::Vector3d m_pos_error {1e-9, 1e-9, 1e-9};  ///< @brief Position detection error
   Eigen::Vector3d m_ang_error {1e-9, 1e-9, 1e-9};  ///< @brief Angular detection error
 };
@@ -43,3 +43,51 @@ TEST(test_fiducial_tracker, constructor) {
   SimFiducialTracker::Parameters sim_params;
   SimFiducialTracker sim_fiducial_tracker(sim_params, truth_engine);
 }
+
+TEST(test_fiducial_tracker, generate_messages_multi_board) {
+  Eigen::Vector3d zero_vec {0, 0, 0};
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto truth_engine = std::make_shared<TruthEngineCyclic>(
+    zero_vec, zero_vec, zero_vec, zero_vec, 0.0, 0.0, 0.0, logger);
+  truth_engine->SetCameraPosition(0, Eigen::Vector3d{0.0, 0.0, 0.0});
+  truth_engine->SetCameraAngularPosition(0, Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0});
+
+  // Two boards in front of the camera and one behind it
+  std::vector<Eigen::Vector3d> board_positions {{0.0, 0.0, 5.0}, {0.5, 0.0, 5.0}, {0.0, 0.0, -5.0}};
+  SimFiducialTracker::Parameters sim_params;
+  sim_params.fiducial_params.logger = logger;
+  sim_params.fiducial_params.min_track_length = 2U;
+  sim_params.fiducial_params.max_track_length = 3U;
+  sim_params.fiducial_params.pos_f_in_g = board_positions[0];
+  sim_params.fiducial_params.ang_f_to_g = Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0};
+  for (unsigned int board_id = 0; board_id < board_positions.size(); ++board_id) {
+    truth_engine->SetBoardPosition(board_id, board_positions[board_id]);
+    truth_engine->SetBoardOrientation(board_id, Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0});
+    if (board_id > 0) {
+      FiducialTracker::BoardParameters board_params;
+      board_params.pos_f_in_g = board_positions[board_id];
+      sim_params.fiducial_params.boards.push_back(board_params);
+    }
+  }
+  SimFiducialTracker sim_fiducial_tracker(sim_params, truth_engine);
+
+  EXPECT_TRUE(sim_fiducial_tracker.IsBoardVisible(0.0, 0, 0));
+  EXPECT_TRUE(sim_fiducial_tracker.IsBoardVisible(0.0, 0, 1));
+  EXPECT_FALSE(sim_fiducial_tracker.IsBoardVisible(0.0, 0, 2));
+
+  std::vector<double> message_times {0.0, 0.1, 0.2, 0.3, 0.4, 0.5};
+  auto messages = sim_fiducial_tracker.GenerateMessages(message_times, 0);
+  ASSERT_EQ(messages.size(), message_times.size());
+  EXPECT_EQ(messages[0]->m_board_tracks.size(), 0U);
+  EXPECT_EQ(messages[1]->m_board_tracks.size(), 0U);
+
+  // Both visible boards are sent together once their tracks are full
+  ASSERT_EQ(messages[2]->m_board_tracks.size(), 2U);
+  for (unsigned int board_id = 0; board_id < 2; ++board_id) {
+    ASSERT_EQ(messages[2]->m_board_tracks[board_id].size(), 3U);
+    for (auto const & board_detection : messages[2]->m_board_tracks[board_id]) {
+      EXPECT_EQ(board_detection.board_id, board_id);
+    }
+  }
+  EXPECT_EQ(messages[5]->m_board_tracks.size(), 2U);
+}
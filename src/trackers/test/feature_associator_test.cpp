@@ -0,0 +1,196 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <eigen3/Eigen/Eigen>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "ekf/ekf.hpp"
+#include "ekf/types.hpp"
+#include "sensors/types.hpp"
+#include "trackers/feature_associator.hpp"
+
+namespace
+{
+
+Intrinsics TestIntrinsics()
+{
+  Intrinsics intrinsics;
+  intrinsics.f_x = 500.0;
+  intrinsics.f_y = 500.0;
+  intrinsics.c_x = 320.0;
+  intrinsics.c_y = 240.0;
+  intrinsics.pixel_size = 1.0;
+  return intrinsics;
+}
+
+FeaturePoint Observe(
+  int frame_id, const Eigen::Vector3d & pos_f_in_g, const Eigen::Vector3d & pos_c_in_g,
+  int feature_id)
+{
+  Intrinsics intrinsics = TestIntrinsics();
+  Eigen::Vector3d pos_f_in_c = pos_f_in_g - pos_c_in_g;
+  FeaturePoint feature_point;
+  feature_point.frame_id = frame_id;
+  feature_point.key_point.pt.x = pos_f_in_c(0) / pos_f_in_c(2) * intrinsics.f_x + intrinsics.c_x;
+  feature_point.key_point.pt.y = pos_f_in_c(1) / pos_f_in_c(2) * intrinsics.f_y + intrinsics.c_y;
+  feature_point.key_point.class_id = feature_id;
+  return feature_point;
+}
+
+/// Stationary stereo pair with a 0.5 m baseline. Camera 1 clones frames 1 and 2,
+/// camera 2 clones frames 3 and 4
+std::shared_ptr<EKF> StereoEKF(std::shared_ptr<DebugLogger> logger)
+{
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  CamState cam_state_2;
+  cam_state_2.pos_c_in_b = Eigen::Vector3d{0.5, 0.0, 0.0};
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+  ekf->RegisterCamera(2, cam_state_2, Eigen::MatrixXd::Zero(6, 6));
+  ekf->AugmentState(1, 1);
+  ekf->AugmentState(2, 3);
+  ekf->AugmentState(1, 2);
+  ekf->AugmentState(2, 4);
+  return ekf;
+}
+
+}  // namespace
+
+TEST(test_feature_associator, epipolar_distance) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = StereoEKF(logger);
+  FeatureAssociator feature_associator(ekf, 0.1, 0.01, logger);
+  feature_associator.AddCamera(1, TestIntrinsics());
+  feature_associator.AddCamera(2, TestIntrinsics());
+
+  Eigen::Vector3d pos_f_in_g {0.2, 0.1, 5.0};
+  Eigen::Vector3d pos_c1_in_g {0.0, 0.0, 0.0};
+  Eigen::Vector3d pos_c2_in_g {0.5, 0.0, 0.0};
+  FeaturePoint point_1 = Observe(1, pos_f_in_g, pos_c1_in_g, 0);
+  FeaturePoint point_2 = Observe(3, pos_f_in_g, pos_c2_in_g, 0);
+  EXPECT_NEAR(feature_associator.EpipolarDistance(1, point_1, 2, point_2), 0.0, 1e-6);
+
+  // Vertical offset of 20 pixels from the epipolar line
+  FeaturePoint point_off = point_2;
+  point_off.key_point.pt.y += 20.0f;
+  EXPECT_NEAR(feature_associator.EpipolarDistance(1, point_1, 2, point_off), 0.04, 1e-6);
+
+  // Rays that only meet behind the cameras
+  FeaturePoint point_behind = point_1;
+  point_behind.frame_id = 3;
+  point_behind.key_point.pt.x += 20.0f;
+  EXPECT_TRUE(std::isinf(feature_associator.EpipolarDistance(1, point_1, 2, point_behind)));
+}
+
+TEST(test_feature_associator, associate) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = StereoEKF(logger);
+  FeatureAssociator feature_associator(ekf, 0.1, 0.01, logger);
+  feature_associator.AddCamera(1, TestIntrinsics());
+  feature_associator.AddCamera(2, TestIntrinsics());
+
+  Eigen::Vector3d pos_f_in_g {0.2, 0.1, 5.0};
+  Eigen::Vector3d pos_other_in_g {-1.0, -0.8, 4.0};
+  Eigen::Vector3d pos_c1_in_g {0.0, 0.0, 0.0};
+  Eigen::Vector3d pos_c2_in_g {0.5, 0.0, 0.0};
+
+  FeatureTracks tracks_1(2);
+  for (int frame_id : {1, 2}) {
+    tracks_1[0].push_back(Observe(frame_id, pos_f_in_g, pos_c1_in_g, 10));
+    tracks_1[1].push_back(Observe(frame_id, pos_other_in_g, pos_c1_in_g, 11));
+  }
+  feature_associator.Associate(1, 0.10, tracks_1);
+  EXPECT_EQ(tracks_1.size(), 0U);
+  EXPECT_EQ(feature_associator.GetPendingCount(), 2U);
+
+  FeatureTracks tracks_2(1);
+  for (int frame_id : {3, 4}) {
+    tracks_2[0].push_back(Observe(frame_id, pos_f_in_g, pos_c2_in_g, 20));
+  }
+  feature_associator.Associate(2, 0.15, tracks_2);
+  ASSERT_EQ(tracks_2.size(), 1U);
+  ASSERT_EQ(tracks_2[0].size(), 4U);
+  EXPECT_EQ(tracks_2[0][0].camera_id, -1);
+  EXPECT_EQ(tracks_2[0][2].camera_id, 1);
+  EXPECT_EQ(tracks_2[0][2].frame_id, 1);
+  EXPECT_EQ(tracks_2[0][2].key_point.class_id, 20);
+  EXPECT_EQ(feature_associator.GetMergedCount(), 1U);
+  EXPECT_EQ(feature_associator.GetPendingCount(), 1U);
+
+  // Unmatched track is released to its own camera once the window has passed
+  FeatureTracks tracks_3;
+  feature_associator.Associate(1, 0.20, tracks_3);
+  ASSERT_EQ(tracks_3.size(), 1U);
+  EXPECT_EQ(tracks_3[0][0].key_point.class_id, 11);
+  EXPECT_EQ(feature_associator.GetPendingCount(), 0U);
+}
+
+TEST(test_feature_associator, clone_horizon) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  Eigen::Vector3d pos_f_in_g {0.2, 0.1, 5.0};
+  Eigen::Vector3d pos_c1_in_g {0.0, 0.0, 0.0};
+  Eigen::Vector3d pos_c2_in_g {0.5, 0.0, 0.0};
+
+  // Window far longer than the clone horizon
+  auto ekf = StereoEKF(logger);
+  ekf->SetMaxTrackLength(2U);
+  FeatureAssociator feature_associator(ekf, 10.0, 0.01, logger);
+  feature_associator.AddCamera(1, TestIntrinsics());
+  feature_associator.AddCamera(2, TestIntrinsics());
+
+  // Track starting on the oldest clone of a full camera is released without waiting
+  FeatureTracks tracks_1(1);
+  for (int frame_id : {1, 2}) {
+    tracks_1[0].push_back(Observe(frame_id, pos_f_in_g, pos_c1_in_g, 10));
+  }
+  feature_associator.Associate(1, 0.10, tracks_1);
+  EXPECT_EQ(tracks_1.size(), 1U);
+  EXPECT_EQ(feature_associator.GetPendingCount(), 0U);
+
+  // Waiting track loses observations of clones marginalized before its partner arrives
+  ekf = StereoEKF(logger);
+  ekf->SetMaxTrackLength(4U);
+  ekf->AugmentState(1, 5);
+  FeatureAssociator window_associator(ekf, 10.0, 0.01, logger);
+  window_associator.AddCamera(1, TestIntrinsics());
+  window_associator.AddCamera(2, TestIntrinsics());
+
+  FeatureTracks tracks_2(1);
+  for (int frame_id : {1, 2, 5}) {
+    tracks_2[0].push_back(Observe(frame_id, pos_f_in_g, pos_c1_in_g, 10));
+  }
+  window_associator.Associate(1, 0.10, tracks_2);
+  EXPECT_EQ(window_associator.GetPendingCount(), 1U);
+
+  ekf->AugmentState(1, 6);
+  ekf->AugmentState(1, 7);
+  ASSERT_FALSE(ekf->HasAugmentedState(1, 1));
+
+  FeatureTracks tracks_3(1);
+  for (int frame_id : {3, 4}) {
+    tracks_3[0].push_back(Observe(frame_id, pos_f_in_g, pos_c2_in_g, 20));
+  }
+  window_associator.Associate(2, 0.15, tracks_3);
+  ASSERT_EQ(tracks_3.size(), 1U);
+  ASSERT_EQ(tracks_3[0].size(), 4U);
+  for (auto const & feature_point : tracks_3[0]) {
+    int camera_id = (feature_point.camera_id < 0) ? 2 : feature_point.camera_id;
+    EXPECT_TRUE(ekf->HasAugmentedState(camera_id, feature_point.frame_id));
+  }
+}
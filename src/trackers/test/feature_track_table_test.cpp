@@ -0,0 +1,100 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ekf/types.hpp"
+#include "trackers/feature_track_table.hpp"
+
+TEST(test_feature_track_table, append_and_pop) {
+  FeatureTrackTable track_table {5U, 4U};
+  for (int frame_id = 0; frame_id < 3; ++frame_id) {
+    track_table.Append(7, frame_id, 1.0f * frame_id, 2.0f * frame_id);
+  }
+  EXPECT_EQ(track_table.Size(), 1U);
+  EXPECT_EQ(track_table.GetTrackLength(7), 3U);
+  EXPECT_EQ(track_table.GetTrackLength(8), 0U);
+
+  std::vector<FeaturePoint> feature_track;
+  track_table.PopTrack(7, feature_track);
+  ASSERT_EQ(feature_track.size(), 3U);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(feature_track[i].frame_id, i);
+    EXPECT_EQ(feature_track[i].key_point.pt.x, 1.0f * i);
+    EXPECT_EQ(feature_track[i].key_point.pt.y, 2.0f * i);
+    EXPECT_EQ(feature_track[i].key_point.class_id, 7);
+  }
+  EXPECT_EQ(track_table.Size(), 0U);
+  EXPECT_EQ(track_table.GetTrackLength(7), 0U);
+}
+
+TEST(test_feature_track_table, ring_overwrite) {
+  FeatureTrackTable track_table {3U, 4U};
+  for (int frame_id = 0; frame_id < 5; ++frame_id) {
+    track_table.Append(1, frame_id, 0.0f, 0.0f);
+  }
+  EXPECT_EQ(track_table.GetTrackLength(1), 3U);
+
+  std::vector<FeaturePoint> feature_track;
+  track_table.PopTrack(1, feature_track);
+  ASSERT_EQ(feature_track.size(), 3U);
+  EXPECT_EQ(feature_track[0].frame_id, 2);
+  EXPECT_EQ(feature_track[2].frame_id, 4);
+}
+
+TEST(test_feature_track_table, find_complete) {
+  FeatureTrackTable track_table {4U, 4U};
+
+  // Feature 3 leaves after the first frame, feature 5 reaches maximum length
+  track_table.Append(3, 0, 0.0f, 0.0f);
+  for (int frame_id = 1; frame_id < 5; ++frame_id) {
+    track_table.Append(5, frame_id, 0.0f, 0.0f);
+    if (frame_id > 1) {
+      track_table.Append(9, frame_id, 0.0f, 0.0f);
+    }
+  }
+
+  std::vector<int> feature_ids;
+  track_table.FindComplete(4, 4U, feature_ids);
+  ASSERT_EQ(feature_ids.size(), 2U);
+  EXPECT_EQ(feature_ids[0], 3);
+  EXPECT_EQ(feature_ids[1], 5);
+}
+
+TEST(test_feature_track_table, churn) {
+  FeatureTrackTable track_table {2U, 8U};
+
+  // Sliding window of live features exercises growth, probing, and backward shift deletion
+  for (int feature_id = 0; feature_id < 2000; ++feature_id) {
+    track_table.Append(feature_id, feature_id, 0.0f, 0.0f);
+    if (feature_id >= 50) {
+      track_table.Erase(feature_id - 50);
+    }
+    if (feature_id % 97 == 0) {
+      for (int live_id = std::max(feature_id - 49, 0); live_id <= feature_id; ++live_id) {
+        ASSERT_EQ(track_table.GetTrackLength(live_id), 1U);
+      }
+    }
+  }
+  EXPECT_EQ(track_table.Size(), 50U);
+  EXPECT_EQ(track_table.GetTrackLength(1949), 0U);
+  EXPECT_EQ(track_table.GetTrackLength(1950), 1U);
+
+  // Slots are recycled rather than grown once the live set is stable
+  EXPECT_LE(track_table.GetSlotCount(), 64U);
+}
@@ -15,8 +15,15 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cmath>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include <opencv2/opencv.hpp>
+
+#include "ekf/ekf.hpp"
 #include "trackers/feature_tracker.hpp"
 
 TEST(test_feature_tracker, initialization) {
@@ -51,3 +58,235 @@ TEST(test_feature_tracker, initialization) {
 
   EXPECT_EQ(feature_tracker_1.GetID(), 1U);
 }
+
+TEST(test_feature_tracker, optical_flow) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.tracking_mode = FeatureTracker::TrackingModeEnum::KLT;
+  params.min_track_length = 100U;
+  params.logger = logger;
+  params.ekf = ekf;
+  FeatureTracker feature_tracker {params};
+
+  // Textured scene translated a few pixels per frame
+  cv::Mat scene(560, 720, CV_8UC1);
+  cv::randu(scene, cv::Scalar(0), cv::Scalar(255));
+  cv::GaussianBlur(scene, scene, cv::Size(5, 5), 1.5);
+
+  for (int frame_id = 0; frame_id < 5; ++frame_id) {
+    cv::Mat img_in = scene(cv::Rect(2 * frame_id, frame_id, 640, 480)).clone();
+    cv::Mat img_out;
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+    feature_tracker.Track(0.1 * frame_id, frame_id, img_in, img_out);
+    auto t_end = std::chrono::high_resolution_clock::now();
+
+    RecordProperty(
+      "klt_us_" + std::to_string(frame_id),
+      std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count());
+    EXPECT_EQ(img_out.cols, 640);
+    EXPECT_EQ(img_out.rows, 480);
+  }
+}
+
+TEST(test_feature_tracker, gyro_prediction) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  BodyState body_state;
+  body_state.m_angular_velocity = Eigen::Vector3d{0.0, 0.0, 1.0};
+  ekf->Initialize(0.0, body_state);
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.min_track_length = 100U;
+  params.intrinsics.f_x = 400.0;
+  params.intrinsics.f_y = 400.0;
+  params.intrinsics.c_x = 320.0;
+  params.intrinsics.c_y = 240.0;
+  params.logger = logger;
+  params.ekf = ekf;
+  FeatureTracker feature_tracker {params};
+
+  cv::Mat img_in(480, 640, CV_8UC1);
+  cv::randu(img_in, cv::Scalar(0), cv::Scalar(255));
+  cv::GaussianBlur(img_in, img_in, cv::Size(5, 5), 1.5);
+  cv::Mat img_out;
+  feature_tracker.Track(0.0, 0, img_in, img_out);
+
+  // Roll about the optical axis rotates points about the principal point
+  std::vector<cv::Point2f> prev_points = feature_tracker.PredictKeyPoints(0.0);
+  std::vector<cv::Point2f> predicted_points = feature_tracker.PredictKeyPoints(0.1);
+  ASSERT_EQ(prev_points.size(), predicted_points.size());
+  ASSERT_GT(prev_points.size(), 0U);
+  for (unsigned int i = 0; i < prev_points.size(); ++i) {
+    cv::Point2f prev_delta = prev_points[i] - cv::Point2f(320.0, 240.0);
+    cv::Point2f pred_delta = predicted_points[i] - cv::Point2f(320.0, 240.0);
+    EXPECT_NEAR(cv::norm(prev_delta), cv::norm(pred_delta), 1e-2);
+    if (cv::norm(prev_delta) > 10.0) {
+      double angle =
+        std::atan2(pred_delta.y, pred_delta.x) - std::atan2(prev_delta.y, prev_delta.x);
+      EXPECT_NEAR(std::remainder(angle, 2 * M_PI), -0.1, 1e-3);
+    }
+  }
+}
+
+TEST(test_feature_tracker, descriptor_matching) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.descriptor = FeatureTracker::DescriptorExtractorEnum::ORB;
+  params.max_features = 100U;
+  params.min_track_length = 2U;
+  params.max_track_length = 2U;
+  params.logger = logger;
+  params.ekf = ekf;
+  FeatureTracker feature_tracker {params};
+
+  // Textured scene translated between two frames. The feature budget caps both frames to the
+  // same key point count, so the descriptor buffer of the second frame has the same size
+  cv::Mat scene(560, 720, CV_8UC1);
+  cv::randu(scene, cv::Scalar(0), cv::Scalar(255));
+  cv::GaussianBlur(scene, scene, cv::Size(5, 5), 1.5);
+
+  FeatureTracks feature_tracks;
+  for (int frame_id = 0; frame_id < 2; ++frame_id) {
+    cv::Mat img_in = scene(cv::Rect(3 * frame_id, 2 * frame_id, 640, 480)).clone();
+    cv::Mat img_out;
+    feature_tracks.clear();
+    feature_tracker.DetectTracks(
+      0.1 * frame_id, frame_id, img_in, img_out, Eigen::Vector3d::Zero(),
+      Eigen::Quaterniond::Identity(), feature_tracks);
+  }
+
+  // Matched features move with the scene. Key points retained in only one of the frames may
+  // still pair with a neighbor, so a few outliers are tolerated
+  ASSERT_GT(feature_tracks.size(), 10U);
+  unsigned int correct_count {0U};
+  for (const auto & feature_track : feature_tracks) {
+    ASSERT_EQ(feature_track.size(), 2U);
+    cv::Point2f delta = feature_track[1].key_point.pt - feature_track[0].key_point.pt;
+    if (cv::norm(delta - cv::Point2f(-3.0f, -2.0f)) < 1.0) {
+      ++correct_count;
+    }
+  }
+  EXPECT_GT(correct_count, 0.9 * feature_tracks.size());
+}
+
+TEST(test_feature_tracker, bucket_features) {
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.nms_cell_size = 10U;
+  params.nms_cell_quota = 2U;
+  FeatureTracker feature_tracker {params};
+
+  std::vector<cv::KeyPoint> key_points;
+  key_points.push_back(cv::KeyPoint(1.0f, 1.0f, 1.0f, -1.0f, 1.0f));
+  key_points.push_back(cv::KeyPoint(2.0f, 2.0f, 1.0f, -1.0f, 3.0f));
+  key_points.push_back(cv::KeyPoint(3.0f, 3.0f, 1.0f, -1.0f, 2.0f));
+  key_points.push_back(cv::KeyPoint(15.0f, 5.0f, 1.0f, -1.0f, 1.0f));
+  key_points.push_back(cv::KeyPoint(-1.0f, 5.0f, 1.0f, -1.0f, 9.0f));
+  key_points.push_back(cv::KeyPoint(5.0f, 25.0f, 1.0f, -1.0f, 9.0f));
+
+  feature_tracker.BucketFeatures(key_points, 20U, 20U);
+
+  // Two strongest of the first cell and the single point in the second
+  ASSERT_EQ(key_points.size(), 3U);
+  EXPECT_EQ(key_points[0].response, 3.0f);
+  EXPECT_EQ(key_points[1].response, 2.0f);
+  EXPECT_EQ(key_points[2].pt.x, 15.0f);
+}
+
+TEST(test_feature_tracker, preprocess_image) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.logger = logger;
+  params.ekf = ekf;
+
+  // Grayscale input at the target resolution is used in place
+  FeatureTracker feature_tracker_1 {params};
+  cv::Mat img_gray(480, 640, CV_8UC1, cv::Scalar(0));
+  cv::Mat img_1 = feature_tracker_1.PreprocessImage(img_gray);
+  EXPECT_EQ(img_1.data, img_gray.data);
+
+  // Color input is converted once and resized to the target resolution
+  cv::Mat img_color(960, 1280, CV_8UC3, cv::Scalar(0, 0, 0));
+  cv::Mat img_2 = feature_tracker_1.PreprocessImage(img_color);
+  EXPECT_EQ(img_2.channels(), 1);
+  EXPECT_EQ(img_2.cols, 640);
+  EXPECT_EQ(img_2.rows, 480);
+
+  // Crop without resize is a view into the input buffer
+  params.image_width = 0U;
+  params.image_height = 0U;
+  params.roi = cv::Rect(100, 50, 320, 240);
+  FeatureTracker feature_tracker_2 {params};
+  cv::Mat img_3 = feature_tracker_2.PreprocessImage(img_gray);
+  EXPECT_EQ(img_3.cols, 320);
+  EXPECT_EQ(img_3.rows, 240);
+  EXPECT_EQ(img_3.data, img_gray(params.roi).data);
+
+  // No output rendering when drawing is disabled
+  cv::Mat img_out;
+  feature_tracker_2.SetDrawOutput(false);
+  feature_tracker_2.Track(0.0, 0, img_gray, img_out);
+  EXPECT_TRUE(img_out.empty());
+}
+
+TEST(test_feature_tracker, feature_budget) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+
+  FeatureTracker::Parameters params;
+  params.sensor_id = 1;
+  params.detector = FeatureTracker::FeatureDetectorEnum::FAST;
+  params.max_features = 400U;
+  params.min_features = 60U;
+  params.target_frame_time = 0.01;
+  params.target_track_count = 100U;
+  params.logger = logger;
+  params.ekf = ekf;
+  FeatureTracker feature_tracker {params};
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 400U);
+
+  // Over the latency target the budget is cut with a bounded step
+  feature_tracker.AdaptFeatureBudget(0.04, 0U);
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 200U);
+  feature_tracker.AdaptFeatureBudget(0.015, 0U);
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 133U);
+
+  // Never below the minimum
+  feature_tracker.AdaptFeatureBudget(1.0, 0U);
+  feature_tracker.AdaptFeatureBudget(1.0, 0U);
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 60U);
+
+  // Spare latency only grows the budget while too few features are tracked
+  feature_tracker.AdaptFeatureBudget(0.001, 200U);
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 60U);
+  feature_tracker.AdaptFeatureBudget(0.001, 10U);
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 75U);
+
+  // Never above the maximum
+  for (unsigned int i = 0; i < 20; ++i) {
+    feature_tracker.AdaptFeatureBudget(0.001, 10U);
+  }
+  EXPECT_EQ(feature_tracker.GetFeatureBudget(), 400U);
+}
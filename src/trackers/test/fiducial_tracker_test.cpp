@@ -13,13 +13,83 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <eigen3/Eigen/Eigen>
 #include <gtest/gtest.h>
 
 #include <memory>
 
+#include <opencv2/aruco.hpp>
+
+#include "ekf/ekf.hpp"
+#include "ekf/types.hpp"
+#include "infrastructure/debug_logger.hpp"
 #include "trackers/fiducial_tracker.hpp"
 
 TEST(test_fiducial_tracker, constructor) {
   FiducialTracker::Parameters params;
   FiducialTracker fiducial_tracker(params);
 }
+
+TEST(test_fiducial_tracker, detector_parameters) {
+  FiducialTracker::Parameters params;
+  params.squares_x = 5U;
+  params.squares_y = 7U;
+  params.square_length = 0.04;
+  params.marker_length = 0.02;
+  params.corner_refinement = cv::aruco::CORNER_REFINE_SUBPIX;
+  params.adaptive_thresh_win_size_min = 5;
+  params.adaptive_thresh_win_size_max = 15;
+  params.adaptive_thresh_win_size_step = 5;
+  params.min_marker_perimeter_rate = 0.1;
+  params.logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  FiducialTracker fiducial_tracker(params);
+
+  cv::Ptr<cv::aruco::DetectorParameters> detector_params =
+    fiducial_tracker.GetDetectorParameters();
+  EXPECT_EQ(detector_params->cornerRefinementMethod, cv::aruco::CORNER_REFINE_SUBPIX);
+  EXPECT_EQ(detector_params->adaptiveThreshWinSizeMin, 5);
+  EXPECT_EQ(detector_params->adaptiveThreshWinSizeMax, 15);
+  EXPECT_EQ(detector_params->adaptiveThreshWinSizeStep, 5);
+  EXPECT_EQ(detector_params->minMarkerPerimeterRate, 0.1);
+
+  // Detector parameters are shared with the tracker for tuning
+  detector_params->minMarkerPerimeterRate = 0.2;
+  EXPECT_EQ(fiducial_tracker.GetDetectorParameters()->minMarkerPerimeterRate, 0.2);
+}
+
+TEST(test_fiducial_tracker, predict_board_roi) {
+  auto logger = std::make_shared<DebugLogger>(LogLevel::FATAL, "");
+  auto ekf = std::make_shared<EKF>(logger, 10.0, false, "");
+  ekf->Initialize(0.0, BodyState());
+  ekf->RegisterCamera(1, CamState(), Eigen::MatrixXd::Zero(6, 6));
+
+  FiducialTracker::Parameters params;
+  params.sensor_id = 1;
+  params.squares_x = 5U;
+  params.squares_y = 7U;
+  params.square_length = 0.04;
+  params.marker_length = 0.02;
+  params.intrinsics.f_x = 500.0;
+  params.intrinsics.f_y = 500.0;
+  params.intrinsics.c_x = 320.0;
+  params.intrinsics.c_y = 240.0;
+  params.pos_f_in_g = Eigen::Vector3d{-0.1, -0.14, 1.0};
+  params.ang_f_to_g = Eigen::Quaterniond{1.0, 0.0, 0.0, 0.0};
+  params.predict_roi = true;
+  params.roi_padding = 0.25;
+  params.logger = logger;
+  params.ekf = ekf;
+  FiducialTracker fiducial_tracker(params);
+
+  // Board spans 100 x 140 pixels about the image center, padded by 35 pixels
+  cv::Rect roi = fiducial_tracker.PredictBoardROI(cv::Size(640, 480));
+  EXPECT_EQ(roi.x, 235);
+  EXPECT_EQ(roi.y, 135);
+  EXPECT_EQ(roi.width, 170);
+  EXPECT_EQ(roi.height, 210);
+
+  // Board behind the camera cannot be predicted
+  params.pos_f_in_g = Eigen::Vector3d{-0.1, -0.14, -1.0};
+  FiducialTracker fiducial_tracker_behind(params);
+  EXPECT_TRUE(fiducial_tracker_behind.PredictBoardROI(cv::Size(640, 480)).empty());
+}
@@ -0,0 +1,76 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "trackers/tracking_pool.hpp"
+
+TEST(test_tracking_pool, thread_count) {
+  TrackingPool tracking_pool_1 {2U};
+  EXPECT_EQ(tracking_pool_1.GetThreadCount(), 2U);
+
+  TrackingPool tracking_pool_2 {0U};
+  EXPECT_GE(tracking_pool_2.GetThreadCount(), 1U);
+}
+
+TEST(test_tracking_pool, concurrent_jobs) {
+  TrackingPool tracking_pool {2U};
+
+  // Two jobs that each wait for the other can only finish if they run concurrently
+  std::atomic<unsigned int> started {0U};
+  for (unsigned int i = 0; i < 2; ++i) {
+    tracking_pool.Submit(
+      [&started]() {
+        ++started;
+        auto t_end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (started < 2U && std::chrono::steady_clock::now() < t_end) {
+          std::this_thread::yield();
+        }
+      });
+  }
+  tracking_pool.Wait();
+  EXPECT_EQ(started, 2U);
+}
+
+TEST(test_tracking_pool, ordered_updates) {
+  TrackingPool tracking_pool {4U};
+
+  // Jobs finish out of order and queue updates with shuffled measurement times
+  std::vector<double> times {0.3, 0.1, 0.4, 0.0, 0.2, 0.1};
+  std::vector<double> applied_times;
+  for (unsigned int i = 0; i < times.size(); ++i) {
+    double time = times[i];
+    tracking_pool.Submit(
+      [&tracking_pool, &applied_times, time, i]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5 * (i % 3)));
+        tracking_pool.QueueUpdate(time, [&applied_times, time]() {applied_times.push_back(time);});
+      });
+  }
+  tracking_pool.Wait();
+
+  EXPECT_EQ(tracking_pool.ProcessUpdates(), times.size());
+  ASSERT_EQ(applied_times.size(), times.size());
+  for (unsigned int i = 1; i < applied_times.size(); ++i) {
+    EXPECT_LE(applied_times[i - 1], applied_times[i]);
+  }
+  EXPECT_EQ(tracking_pool.ProcessUpdates(), 0U);
+}
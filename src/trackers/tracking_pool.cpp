@@ -0,0 +1,116 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "trackers/tracking_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+TrackingPool::TrackingPool(unsigned int thread_count)
+{
+  if (thread_count == 0U) {
+    thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    m_threads.emplace_back(&TrackingPool::Worker, this);
+  }
+}
+
+TrackingPool::~TrackingPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_stop = true;
+  }
+  m_job_condition.notify_all();
+  for (auto & thread : m_threads) {
+    thread.join();
+  }
+}
+
+void TrackingPool::Submit(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_job_mutex);
+    m_jobs.push_back(std::move(job));
+  }
+  m_job_condition.notify_one();
+}
+
+void TrackingPool::QueueUpdate(double time, std::function<void()> update)
+{
+  std::lock_guard<std::mutex> lock(m_update_mutex);
+  m_updates.push(QueuedUpdate{time, m_update_sequence++, std::move(update)});
+}
+
+unsigned int TrackingPool::ProcessUpdates()
+{
+  unsigned int update_count {0U};
+  while (true) {
+    std::function<void()> update;
+    {
+      std::lock_guard<std::mutex> lock(m_update_mutex);
+      if (m_updates.empty()) {
+        break;
+      }
+      update = m_updates.top().update;
+      m_updates.pop();
+    }
+    update();
+    ++update_count;
+  }
+  return update_count;
+}
+
+void TrackingPool::Wait()
+{
+  std::unique_lock<std::mutex> lock(m_job_mutex);
+  m_idle_condition.wait(lock, [this] {return m_jobs.empty() && (m_active_jobs == 0U);});
+}
+
+unsigned int TrackingPool::GetThreadCount()
+{
+  return m_threads.size();
+}
+
+void TrackingPool::Worker()
+{
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(m_job_mutex);
+      m_job_condition.wait(lock, [this] {return m_stop || !m_jobs.empty();});
+      if (m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      ++m_active_jobs;
+    }
+
+    job();
+
+    {
+      std::lock_guard<std::mutex> lock(m_job_mutex);
+      --m_active_jobs;
+    }
+    m_idle_condition.notify_all();
+  }
+}
@@ -0,0 +1,112 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef TRACKERS__TRACKING_POOL_HPP_
+#define TRACKERS__TRACKING_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+///
+/// @class TrackingPool
+/// @brief Worker pool running tracking jobs with an ordered queue of resulting EKF updates
+///
+class TrackingPool
+{
+public:
+  ///
+  /// @brief TrackingPool constructor
+  /// @param thread_count Number of worker threads. Zero uses the hardware concurrency
+  ///
+  explicit TrackingPool(unsigned int thread_count = 0U);
+
+  ///
+  /// @brief TrackingPool destructor. Finishes queued jobs and joins the workers
+  ///
+  ~TrackingPool();
+
+  ///
+  /// @brief Queue a tracking job to run on a worker thread
+  /// @param job Tracking job
+  ///
+  void Submit(std::function<void()> job);
+
+  ///
+  /// @brief Queue an EKF update to be applied by ProcessUpdates
+  /// @param time Measurement time of the update
+  /// @param update Update function
+  ///
+  void QueueUpdate(double time, std::function<void()> update);
+
+  ///
+  /// @brief Apply all queued updates on the calling thread in timestamp order
+  /// @return Number of updates applied
+  ///
+  unsigned int ProcessUpdates();
+
+  ///
+  /// @brief Block until all submitted jobs have finished
+  ///
+  void Wait();
+
+  ///
+  /// @brief Worker thread count getter method
+  /// @return Number of worker threads
+  ///
+  unsigned int GetThreadCount();
+
+private:
+  ///
+  /// @brief Queued EKF update
+  ///
+  typedef struct QueuedUpdate
+  {
+    double time;                  ///< @brief Measurement time
+    unsigned int sequence;        ///< @brief Queue order for updates with equal times
+    std::function<void()> update;  ///< @brief Update function
+  } QueuedUpdate;
+
+  ///
+  /// @brief Ordering placing the earliest update at the top of the queue
+  ///
+  struct LaterUpdate
+  {
+    bool operator()(const QueuedUpdate & a, const QueuedUpdate & b) const
+    {
+      return (a.time > b.time) || ((a.time == b.time) && (a.sequence > b.sequence));
+    }
+  };
+
+  void Worker();
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_job_mutex;
+  std::condition_variable m_job_condition;
+  std::condition_variable m_idle_condition;
+  std::deque<std::function<void()>> m_jobs;
+  unsigned int m_active_jobs {0U};
+  bool m_stop {false};
+
+  std::mutex m_update_mutex;
+  std::priority_queue<QueuedUpdate, std::vector<QueuedUpdate>, LaterUpdate> m_updates;
+  unsigned int m_update_sequence {0U};
+};
+
+#endif  // TRACKERS__TRACKING_POOL_HPP_
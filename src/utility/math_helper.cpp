@@ -18,6 +18,7 @@
 #include <eigen3/Eigen/Eigen>
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "utility/type_helper.hpp"
@@ -183,6 +184,27 @@ void CompressMeasurements(Eigen::MatrixXd & jacobian, Eigen::VectorXd & residual
   }
 }
 
+double ChiSquared95(unsigned int dof)
+{
+  static const std::vector<double> chi_squared_table {
+    3.8415, 5.9915, 7.8147, 9.4877, 11.0705, 12.5916, 14.0671, 15.5073, 16.9190, 18.3070,
+    19.6751, 21.0261, 22.3620, 23.6848, 24.9958, 26.2962, 27.5871, 28.8693, 30.1435, 31.4104,
+    32.6706, 33.9244, 35.1725, 36.4150, 37.6525, 38.8851, 40.1133, 41.3371, 42.5570, 43.7730,
+    44.9853, 46.1943, 47.3999, 48.6024, 49.8018, 50.9985, 52.1923, 53.3835, 54.5722, 55.7585,
+    56.9424, 58.1240, 59.3035, 60.4809, 61.6562, 62.8296, 64.0011, 65.1708, 66.3386, 67.5048};
+
+  if (dof == 0) {
+    return 0.0;
+  } else if (dof <= chi_squared_table.size()) {
+    return chi_squared_table[dof - 1];
+  }
+
+  // Wilson-Hilferty approximation is accurate to within 0.01% beyond the table
+  double z_95 = 1.6448536269514722;
+  double k = static_cast<double>(dof);
+  double cube_root = 1.0 - 2.0 / (9.0 * k) + z_95 * std::sqrt(2.0 / (9.0 * k));
+  return k * cube_root * cube_root * cube_root;
+}
 
 Eigen::Quaterniond average_quaternions(
   std::vector<Eigen::Quaterniond> quaternions,
@@ -236,7 +258,7 @@ Eigen::Vector3d average_vectors(
   return average_vector / weights_sum;
 }
 
-Eigen::MatrixXd quaternion_jacobian(Eigen::Quaterniond quat)
+Eigen::Matrix3d quaternion_jacobian(Eigen::Quaterniond quat)
 {
   Eigen::Vector3d rot_vec = QuatToRotVec(quat);
   Eigen::Matrix3d skew_mat = SkewSymmetric(rot_vec);
@@ -250,7 +272,7 @@ Eigen::MatrixXd quaternion_jacobian(Eigen::Quaterniond quat)
   return jacobian;
 }
 
-Eigen::MatrixXd quaternion_jacobian_inv(Eigen::Quaterniond quat)
+Eigen::Matrix3d quaternion_jacobian_inv(Eigen::Quaterniond quat)
 {
   Eigen::Vector3d rot_vec = QuatToRotVec(quat);
   Eigen::Matrix3d skew_mat = SkewSymmetric(rot_vec);
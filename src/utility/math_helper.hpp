@@ -96,6 +96,13 @@ void ApplyLeftNullspace(Eigen::MatrixXd & H_f, Eigen::MatrixXd & H_x, Eigen::Vec
 ///
 void CompressMeasurements(Eigen::MatrixXd & jacobian, Eigen::VectorXd & residual);
 
+///
+/// @brief Look up the 95% chi-squared quantile
+/// @param dof Degrees of freedom
+/// @return Chi-squared threshold
+///
+double ChiSquared95(unsigned int dof);
+
 ///
 /// @brief Find average of multiple quaternions
 /// @param quaternions Vector of quaternions to average
@@ -119,14 +126,14 @@ Eigen::Vector3d average_vectors(std::vector<Eigen::Vector3d> vectors, std::vecto
 /// @param quat Input quaternion
 /// @return Jacobian matrix
 ///
-Eigen::MatrixXd quaternion_jacobian(Eigen::Quaterniond quat);
+Eigen::Matrix3d quaternion_jacobian(Eigen::Quaterniond quat);
 
 ///
 /// @brief Calculate inverse jacobian of quaternion with respect to a rotation measurement
 /// @param quat Input quaternion
 /// @return Inverse Jacobian matrix
 ///
-Eigen::MatrixXd quaternion_jacobian_inv(Eigen::Quaterniond quat);
+Eigen::Matrix3d quaternion_jacobian_inv(Eigen::Quaterniond quat);
 
 
 #endif  // UTILITY__MATH_HELPER_HPP_
@@ -17,34 +17,112 @@
 
 #include <eigen3/Eigen/Eigen>
 
-#include <sstream>
+#include <algorithm>
+#include <cstdio>
 #include <string>
 
+namespace
+{
+// Longest %.17g double or 64-bit integer, including sign, exponent and terminator
+constexpr unsigned int g_max_value_chars {32U};
+}  // namespace
 
-std::string EnumerateHeader(std::string name, unsigned int size)
+std::string EnumerateHeader(const std::string & name, unsigned int size)
 {
-  std::stringstream stream;
+  std::string header;
   for (unsigned int i = 0; i < size; ++i) {
-    stream << "," << name << "_" << std::to_string(i);
+    header += ",";
+    header += name;
+    header += "_";
+    header += std::to_string(i);
+  }
+  return header;
+}
+
+std::string VectorToCommaString(const Eigen::Ref<const Eigen::VectorXd> & vec)
+{
+  if (vec.size() == 0) {
+    return "";
   }
-  return stream.str();
+  CsvRecord record;
+  record.Append(vec);
+  return "," + record.String();
+}
+
+std::string QuaternionToCommaString(const Eigen::Quaterniond & quat)
+{
+  CsvRecord record;
+  record.Append(quat);
+  return "," + record.String();
+}
+
+CsvRecord::CsvRecord(unsigned int precision)
+{
+  SetPrecision(precision);
+}
+
+void CsvRecord::Clear()
+{
+  m_buffer.clear();
+}
+
+void CsvRecord::SetPrecision(unsigned int precision)
+{
+  m_precision = static_cast<int>(std::min(std::max(precision, 1U), 17U));
+}
+
+unsigned int CsvRecord::GetPrecision() const
+{
+  return static_cast<unsigned int>(m_precision);
 }
 
-std::string VectorToCommaString(Eigen::VectorXd vec)
+void CsvRecord::AppendSeparator()
 {
-  std::stringstream stream;
-  for (unsigned int i = 0; i < vec.size(); ++i) {
-    stream << "," << vec[i];
+  if (!m_buffer.empty()) {
+    m_buffer.push_back(',');
   }
-  return stream.str();
 }
 
-std::string QuaternionToCommaString(Eigen::Quaterniond quat)
+CsvRecord & CsvRecord::Append(double value)
+{
+  AppendSeparator();
+  size_t size = m_buffer.size();
+  m_buffer.resize(size + g_max_value_chars);
+  int length = std::snprintf(&m_buffer[size], g_max_value_chars, "%.*g", m_precision, value);
+  m_buffer.resize(size + length);
+  return *this;
+}
+
+CsvRecord & CsvRecord::AppendSigned(long long value)  // NOLINT(runtime/int)
+{
+  AppendSeparator();
+  size_t size = m_buffer.size();
+  m_buffer.resize(size + g_max_value_chars);
+  int length = std::snprintf(&m_buffer[size], g_max_value_chars, "%lld", value);
+  m_buffer.resize(size + length);
+  return *this;
+}
+
+CsvRecord & CsvRecord::AppendUnsigned(unsigned long long value)  // NOLINT(runtime/int)
+{
+  AppendSeparator();
+  size_t size = m_buffer.size();
+  m_buffer.resize(size + g_max_value_chars);
+  int length = std::snprintf(&m_buffer[size], g_max_value_chars, "%llu", value);
+  m_buffer.resize(size + length);
+  return *this;
+}
+
+CsvRecord & CsvRecord::Append(const Eigen::Quaterniond & quat)
+{
+  Append(quat.w());
+  Append(quat.x());
+  Append(quat.y());
+  Append(quat.z());
+  return *this;
+}
+
+const std::string & CsvRecord::String() const
 {
-  std::stringstream stream;
-  stream << "," << quat.w();
-  stream << "," << quat.x();
-  stream << "," << quat.y();
-  stream << "," << quat.z();
-  return stream.str();
+  return m_buffer;
 }
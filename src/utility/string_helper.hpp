@@ -19,6 +19,7 @@
 #include <eigen3/Eigen/Eigen>
 
 #include <string>
+#include <type_traits>
 
 ///
 /// @brief Creates comma-separated enumerated list
@@ -26,20 +27,115 @@
 /// @param size Header count
 /// @return Comma-separated, enumerated header string
 ///
-std::string EnumerateHeader(std::string name, unsigned int size);
+std::string EnumerateHeader(const std::string & name, unsigned int size);
 
 ///
 /// @brief Create comma-separated string from vector
 /// @param vec Input vector
 /// @return Comma-separated string vector
 ///
-std::string VectorToCommaString(Eigen::VectorXd vec);
+std::string VectorToCommaString(const Eigen::Ref<const Eigen::VectorXd> & vec);
 
 ///
 /// @brief Create comma-separated string from quaternion
 /// @param quat Input quaternion
 /// @return Comma-separated string quaternion
 ///
-std::string QuaternionToCommaString(Eigen::Quaterniond quat);
+std::string QuaternionToCommaString(const Eigen::Quaterniond & quat);
+
+///
+/// @class CsvRecord
+/// @brief Comma-separated record formatted into a reusable buffer
+///
+/// Values are printed straight into the buffer, so once it has grown to the record length no
+/// further allocations are made. Doubles use the given number of significant digits, where the
+/// default of 6 matches the default stream output and 17 round-trips every value.
+///
+/// Values are printed with snprintf, which follows the LC_NUMERIC locale. Any locale other than
+/// "C" may print a comma as the decimal separator. That splits values across CSV columns and
+/// breaks the strtod parsing of text records written to binary logs.
+///
+class CsvRecord
+{
+public:
+  ///
+  /// @brief CsvRecord constructor
+  /// @param precision Significant digits of floating point values
+  ///
+  explicit CsvRecord(unsigned int precision = 6U);
+
+  ///
+  /// @brief Clear the record while keeping the buffer capacity
+  ///
+  void Clear();
+
+  ///
+  /// @brief Floating point precision setter
+  /// @param precision Significant digits of floating point values, from 1 to 17
+  ///
+  void SetPrecision(unsigned int precision);
+
+  ///
+  /// @brief Floating point precision getter
+  /// @return Significant digits of floating point values
+  ///
+  unsigned int GetPrecision() const;
+
+  ///
+  /// @brief Append a floating point value
+  /// @param value Value to append
+  /// @return Reference to this record
+  ///
+  CsvRecord & Append(double value);
+
+  ///
+  /// @brief Append an integer value
+  /// @param value Value to append
+  /// @return Reference to this record
+  ///
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value, CsvRecord &>::type Append(T value)
+  {
+    if (std::is_signed<T>::value) {
+      return AppendSigned(static_cast<long long>(value));  // NOLINT(runtime/int)
+    }
+    return AppendUnsigned(static_cast<unsigned long long>(value));  // NOLINT(runtime/int)
+  }
+
+  ///
+  /// @brief Append every coefficient of an Eigen vector or expression without copying it
+  /// @param vec Vector expression to append
+  /// @return Reference to this record
+  ///
+  template<typename Derived>
+  CsvRecord & Append(const Eigen::DenseBase<Derived> & vec)
+  {
+    for (Eigen::Index i = 0; i < vec.size(); ++i) {
+      Append(static_cast<double>(vec.coeff(i)));
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief Append a quaternion in w, x, y, z order
+  /// @param quat Quaternion to append
+  /// @return Reference to this record
+  ///
+  CsvRecord & Append(const Eigen::Quaterniond & quat);
+
+  ///
+  /// @brief Record contents getter
+  /// @return Comma-separated record
+  ///
+  const std::string & String() const;
+
+private:
+  CsvRecord & AppendSigned(long long value);  // NOLINT(runtime/int)
+  CsvRecord & AppendUnsigned(unsigned long long value);  // NOLINT(runtime/int)
+  void AppendSeparator();
+
+  std::string m_buffer;
+  int m_precision {6};
+};
 
 #endif  // UTILITY__STRING_HELPER_HPP_
@@ -295,3 +295,11 @@ TEST(test_MathHelper, quaternion_jacobian_inv) {
   Eigen::Matrix3d jac = quaternion_jacobian_inv(quat);
   EXPECT_TRUE(EXPECT_EIGEN_NEAR(jac, Eigen::Matrix3d::Identity(), 1e-6));
 }
+
+TEST(test_MathHelper, ChiSquared95) {
+  EXPECT_EQ(ChiSquared95(0), 0.0);
+  EXPECT_NEAR(ChiSquared95(1), 3.8415, 1e-4);
+  EXPECT_NEAR(ChiSquared95(50), 67.5048, 1e-4);
+  EXPECT_NEAR(ChiSquared95(51), 68.6693, 1e-2);
+  EXPECT_NEAR(ChiSquared95(100), 124.3421, 1e-2);
+}
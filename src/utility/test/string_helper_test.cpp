@@ -0,0 +1,65 @@
+// Copyright 2023 Jacob Hartzer
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <eigen3/Eigen/Eigen>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "utility/string_helper.hpp"
+
+
+TEST(test_StringHelper, EnumerateHeader) {
+  EXPECT_EQ(EnumerateHeader("acc", 3), ",acc_0,acc_1,acc_2");
+  EXPECT_EQ(EnumerateHeader("acc", 0), "");
+}
+
+TEST(test_StringHelper, CommaStrings) {
+  Eigen::Vector3d vec(1.5, -2.0, 0.1);
+  std::stringstream expected;
+  expected << "," << vec(0) << "," << vec(1) << "," << vec(2);
+  EXPECT_EQ(VectorToCommaString(vec), expected.str());
+
+  Eigen::Quaterniond quat(0.5, 0.5, -0.5, 0.5);
+  EXPECT_EQ(QuaternionToCommaString(quat), ",0.5,0.5,-0.5,0.5");
+}
+
+TEST(test_StringHelper, CsvRecord) {
+  CsvRecord record;
+  record.Append(1.0 / 3.0).Append(-4).Append(7U);
+  record.Append(Eigen::Vector2d(1.0, 2.0).array() * 2.0);
+  record.Append(Eigen::Quaterniond::Identity());
+  EXPECT_EQ(record.String(), "0.333333,-4,7,2,4,1,0,0,0");
+
+  record.Clear();
+  EXPECT_EQ(record.String(), "");
+
+  record.SetPrecision(3U);
+  record.Append(123.456);
+  EXPECT_EQ(record.String(), "123");
+
+  record.SetPrecision(0U);
+  EXPECT_EQ(record.GetPrecision(), 1U);
+  record.SetPrecision(100U);
+  EXPECT_EQ(record.GetPrecision(), 17U);
+
+  // Full precision round-trips every value
+  double value = 0.1 + 0.2;
+  record.Clear();
+  record.Append(value);
+  EXPECT_EQ(std::strtod(record.String().c_str(), nullptr), value);
+}
@@ -112,7 +112,7 @@ Eigen::Quaterniond RodriguesToQuat(cv::Vec3d rodrigues_vector)
   return quat;
 }
 
-void CvVectorToEigen(cv::Vec3d & vector_cv, Eigen::Vector3d & vector_eigen)
+void CvVectorToEigen(const cv::Vec3d & vector_cv, Eigen::Vector3d & vector_eigen)
 {
   for (unsigned int i = 0; i < 3; ++i) {
     vector_eigen(i) = vector_cv[i];
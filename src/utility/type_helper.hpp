@@ -90,6 +90,6 @@ Eigen::Quaterniond RodriguesToQuat(cv::Vec3d rodrigues_vector);
 /// @param vector_cv Input CV vector
 /// @param vector_eigen Output Eigen vector
 ///
-void CvVectorToEigen(cv::Vec3d & vector_cv, Eigen::Vector3d & vector_eigen);
+void CvVectorToEigen(const cv::Vec3d & vector_cv, Eigen::Vector3d & vector_eigen);
 
 #endif  // UTILITY__TYPE_HELPER_HPP_